@@ -0,0 +1,78 @@
+//
+// AdaptiveEngine.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef ADAPTIVEENGINE_HPP_
+#define ADAPTIVEENGINE_HPP_
+
+#include <vector>
+#include <cstdint>
+
+namespace ge
+{
+
+// Picks the engine for the next stretch of generations from what the
+// simulator measures on every pass. A busy grid is dense: every tile is
+// computed anyway, so the engine that streams memory least wins. A grid
+// that is mostly still, or only repeats itself, is sparse: the engine that
+// skips still tiles wins. The choice is revisited once per Window
+// generations, with a gap between the thresholds and a minimum stay on a
+// regime so a grid near the boundary does not flip back and forth. Every
+// switch is logged, and so is the time per generation it bought.
+class AdaptiveEngine
+{
+public:
+  enum class Regime
+  {
+    Sparse,
+    Dense,
+  };
+
+  // one pass of the simulator
+  struct Sample
+  {
+    int generations;
+    uint64_t population;
+    double changedFraction; // of the tiles, over the pass
+    double seconds;
+  };
+
+  static constexpr uint64_t Window = 64;
+  // changed tile fractions to enter and to leave the dense regime
+  static constexpr double DenseAbove = 0.3;
+  static constexpr double SparseBelow = 0.15;
+  // windows on a regime before it may be left again
+  static constexpr int MinWindows = 2;
+  // longest period, in passes, the population trace is checked for
+  static constexpr int MaxPeriod = 8;
+
+  void reset(Regime regime);
+  Regime regime() const { return m_regime; }
+  // adds a pass ending at `generation`, returns the regime to run next
+  Regime record(const Sample& sample, uint64_t generation);
+
+  static const char* name(Regime regime);
+
+private:
+  // the population of the window's passes repeats with a short period
+  bool repeating() const;
+
+  Regime m_regime = Regime::Sparse;
+  int m_windows = 0; // full windows since the last switch
+  // the current window
+  uint64_t m_generations = 0;
+  double m_seconds = 0;
+  double m_changed = 0; // changed fraction times generations
+  std::vector<uint64_t> m_populations;
+  // seconds per generation before the last switch, 0 once its payoff has
+  // been logged
+  double m_before = 0;
+};
+
+} // namespace ge
+
+#endif // ADAPTIVEENGINE_HPP_
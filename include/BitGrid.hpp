@@ -0,0 +1,71 @@
+//
+// BitGrid.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef BITGRID_HPP_
+#define BITGRID_HPP_
+
+#include "Vector.hpp"
+#include "BitStorage.hpp"
+#include "GridStats.hpp"
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace ge
+{
+
+// A headless torus at one bit per cell, for grids far past what the
+// byte-per-cell simulator with its fades and pyramid can hold. A row is
+// an array of 64-bit words with cell x in bit x % 64 of word x / 64; the
+// bits past the grid width stay clear. The generations live in a
+// BitStorage, in memory unless another one is given.
+class BitGrid
+{
+public:
+  bool init(const ivec2& gridSize, std::unique_ptr<BitStorage> storage = nullptr);
+
+  // about `percentage` percent of the cells alive; every row has its own
+  // generator, so the soup does not depend on the number of workers
+  void fillRandom(uint64_t seed, int percentage);
+  // row-major bytes, non-zero for live cells, as Simulator::snapshot
+  void load(const uint8_t* rows);
+  void store(uint8_t* rows) const;
+
+  // one generation, stripe by stripe with a band of rows per worker
+  void step();
+  // counts of the last step, gathered by the kernel
+  const GridStats& stats() const { return m_stats; }
+  // counts the live cells in another pass over the grid
+  uint64_t population() const;
+
+  const ivec2& gridSize() const { return m_gridSize; }
+  uint64_t cellCount() const
+  {
+    return static_cast<uint64_t>(m_gridSize.w) * m_gridSize.h;
+  }
+
+private:
+  void advanceRow(const uint64_t* up, const uint64_t* mid,
+      const uint64_t* down, uint64_t* out, int64_t y, GridStats& stats) const;
+  // calls rows(begin, end) for one band of rows [begin, end) per worker
+  template <typename Rows>
+  void forEachBand(int64_t begin, int64_t end, Rows&& rows) const;
+  // rows of one stripe of the storage
+  int64_t stripeRows() const;
+
+  ivec2 m_gridSize;
+  size_t m_words; // per row
+  uint64_t m_lastMask; // the cells of the last word of a row
+  std::unique_ptr<BitStorage> m_storage;
+  GridStats m_stats;
+};
+
+} // namespace ge
+
+#endif // BITGRID_HPP_
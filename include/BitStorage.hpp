@@ -0,0 +1,112 @@
+//
+// BitStorage.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef BITSTORAGE_HPP_
+#define BITSTORAGE_HPP_
+
+#include "GridBuffer.hpp"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace ge
+{
+
+// Where a BitGrid keeps its current and next generation, `words` 64-bit
+// words each. The grid is swept in stripes of rows; storage that is not
+// all in memory is told which words a stripe is about to read and which
+// it is done with.
+class BitStorage
+{
+public:
+  virtual ~BitStorage() { }
+
+  virtual bool allocate(size_t words) = 0;
+  virtual uint64_t* current() = 0;
+  virtual uint64_t* next() = 0;
+  // the next generation becomes the current one
+  virtual void swap() = 0;
+
+  // bytes worth sweeping in one stripe, 0 for the whole grid
+  virtual size_t stripeBytes() const { return 0; }
+  // words [begin, end) of the current generation are read soon
+  virtual void willRead(size_t /*begin*/, size_t /*end*/) { }
+  // words [begin, end) of the current generation are not read again
+  // this sweep
+  virtual void doneReading(size_t /*begin*/, size_t /*end*/) { }
+  // words [begin, end) of the generation just filled are final
+  virtual void written(uint64_t* /*words*/, size_t /*begin*/,
+      size_t /*end*/) { }
+};
+
+// both generations in memory
+class MemoryBitStorage : public BitStorage
+{
+public:
+  bool allocate(size_t words) override;
+  uint64_t* current() override { return m_current.data(); }
+  uint64_t* next() override { return m_next.data(); }
+  void swap() override { m_current.swap(m_next); }
+
+private:
+  GridBuffer<uint64_t> m_current;
+  GridBuffer<uint64_t> m_next;
+};
+
+// Both generations in a memory-mapped file, for grids larger than the
+// memory. Stripes ahead of the sweep are prefetched with MADV_WILLNEED and
+// the ones behind it dropped, so the page cache only holds a window of
+// the grid and the file is read and written in order. The file keeps the
+// grid size and the generation, and a later run of the same grid picks
+// up where the last one stopped.
+class MappedBitStorage : public BitStorage
+{
+public:
+  static constexpr size_t StripeBytes = size_t(64) << 20;
+
+  MappedBitStorage(std::string path, int width, int height);
+  ~MappedBitStorage();
+
+  bool allocate(size_t words) override;
+  uint64_t* current() override;
+  uint64_t* next() override;
+  void swap() override;
+
+  size_t stripeBytes() const override { return StripeBytes; }
+  void willRead(size_t begin, size_t end) override;
+  void doneReading(size_t begin, size_t end) override;
+  void written(uint64_t* words, size_t begin, size_t end) override;
+
+  // the file held this grid already
+  bool resumed() const { return m_resumed; }
+  uint64_t generation() const;
+
+private:
+  struct Header;
+
+  Header* header() const;
+  uint64_t* half(int which) const;
+  // the page-aligned byte range of words [begin, end) of `words`, the
+  // pages partly in it included or not
+  void pages(const uint64_t* words, size_t begin, size_t end, bool partial,
+      size_t& offset, size_t& size) const;
+
+  std::string m_path;
+  int m_width;
+  int m_height;
+  int m_file;
+  uint8_t* m_mapping;
+  size_t m_mappedBytes;
+  size_t m_halfBytes;
+  bool m_resumed;
+};
+
+} // namespace ge
+
+#endif // BITSTORAGE_HPP_
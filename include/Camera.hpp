@@ -0,0 +1,71 @@
+//
+// Camera.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef CAMERA_HPP_
+#define CAMERA_HPP_
+
+#include "Vector.hpp"
+
+#include <cmath>
+
+namespace ge
+{
+
+struct Camera
+{
+  vec2 position; // grid coordinates of the top left screen corner
+  float zoom;    // pixels per cell
+  ivec2 viewport;
+
+  static constexpr float MinZoom = 1.f / 1024.f;
+  static constexpr float MaxZoom = 256.f;
+
+  vec2 toGrid(vec2 screen) const
+  {
+    return vec2(position.x + screen.x / zoom, position.y + screen.y / zoom);
+  }
+
+  void zoomAt(vec2 screen, float factor)
+  {
+    vec2 anchor = toGrid(screen);
+    zoom = CLAMP(zoom * factor, MinZoom, MaxZoom);
+    position = vec2(anchor.x - screen.x / zoom, anchor.y - screen.y / zoom);
+  }
+
+  void fit(const ivec2& gridSize)
+  {
+    zoom = MIN(static_cast<float>(viewport.w) / gridSize.w,
+               static_cast<float>(viewport.h) / gridSize.h);
+    position = vec2();
+  }
+
+  // cells per drawn block, 1 while a cell covers at least a pixel
+  int blockSize() const
+  {
+    int block = 1;
+    while (block * zoom < 1.f)
+      block <<= 1;
+    return block;
+  }
+
+  // visible cell range [begin, end) clipped to the grid, aligned to `block`
+  void visibleRange(const ivec2& gridSize, int block,
+      ivec2& begin, ivec2& end) const
+  {
+    begin.x = MAX(0, SNAP(static_cast<int>(std::floor(position.x)), block));
+    begin.y = MAX(0, SNAP(static_cast<int>(std::floor(position.y)), block));
+    end.x = MIN(gridSize.w,
+        static_cast<int>(std::ceil(position.x + viewport.w / zoom)) + 1);
+    end.y = MIN(gridSize.h,
+        static_cast<int>(std::ceil(position.y + viewport.h / zoom)) + 1);
+  }
+};
+
+} // namespace ge
+
+#endif // CAMERA_HPP_
@@ -0,0 +1,89 @@
+//
+// Capture.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef CAPTURE_HPP_
+#define CAPTURE_HPP_
+
+#include "Vector.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+
+namespace ge
+{
+
+// Records presented frames to a Y4M file or a directory of PPM images.
+// Frames are read back into a ring of pixel pack buffers and mapped a
+// couple of frames later; encoding runs on a writer thread. When the
+// readback is not ready or the queue is full the frame is dropped, the
+// render loop never waits.
+class Capture
+{
+public:
+  Capture();
+  ~Capture();
+
+  // `path` ending in .y4m writes one video file, anything else a directory
+  bool start(std::string_view path, ivec2 size, int fps);
+  void stop();
+  bool active() const;
+
+  // after the frame is drawn, before it is swapped
+  void readFrame();
+
+private:
+  struct Frame
+  {
+    std::vector<uint8_t> pixels; // bottom-up RGBA as read from GL
+    uint64_t index;
+  };
+
+  void collect(int slot);
+  void writerLoop();
+  void writeY4M(const Frame& frame);
+  void writePPM(const Frame& frame);
+
+  static constexpr int RingSize = 3;
+  static constexpr int QueueLimit = 8;
+
+  ivec2 m_size;
+  // GL rows below the captured ones: the bottom row of an odd height
+  int m_skipRows;
+  bool m_active;
+  bool m_y4m;
+  std::string m_path;
+  std::ofstream m_video;
+  std::vector<uint8_t> m_scratch;
+
+  uint32_t m_buffers[RingSize];
+  void* m_fences[RingSize];
+  uint64_t m_slotFrame[RingSize];
+  uint64_t m_frame;
+  uint64_t m_written;
+  uint64_t m_dropped;
+
+  std::thread m_writer;
+  std::mutex m_mutex;
+  std::condition_variable m_ready;
+  std::deque<std::unique_ptr<Frame>> m_queue;
+  std::vector<std::unique_ptr<Frame>> m_free;
+  int m_allocated;
+  bool m_stopping;
+};
+
+} // namespace ge
+
+#endif // CAPTURE_HPP_
@@ -0,0 +1,82 @@
+//
+// Census.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef CENSUS_HPP_
+#define CENSUS_HPP_
+
+#include "Vector.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ge
+{
+
+// Counts the objects of settled grids by their apgcode. The live cells are
+// labelled into 8-connected components with a union-find pass, one band of
+// rows per worker, on the torus. Each object is then run alone until it
+// comes back to its first phase: a still life is xs<cells>, an oscillator
+// xp<period> and a spaceship xq<period>, followed by the extended Wechsler
+// code of the phase and orientation with the shortest, then the smallest,
+// code. Objects seen before are looked up by their cells instead of being
+// run again, so the census of a soup mostly costs the labelling.
+class Census
+{
+public:
+  // generations an object is run alone for before it is given up on
+  static constexpr int MaxPeriod = 64;
+  // longest side of an object that is still run alone
+  static constexpr int MaxSide = 64;
+  // classified objects remembered, forgotten all at once past this
+  static constexpr size_t MaxKnown = 1 << 16;
+
+  // adds the objects of a grid, row-major bytes, non-zero for live cells,
+  // as Simulator::snapshot writes them; a grid of more cells than 32 bits
+  // can index is logged and skipped
+  void add(const std::vector<uint8_t>& cells, const ivec2& gridSize);
+  void clear();
+
+  // apgcode to the number of objects
+  const std::map<std::string, uint64_t>& counts() const { return m_counts; }
+  uint64_t objects() const { return m_objects; }
+  // logs the most common objects
+  void log(size_t top) const;
+
+  // the apgcode of one object, w x h row-major bytes; one that does not
+  // repeat in MaxPeriod generations is zz_ with the code of its cells
+  static std::string classify(const std::vector<uint8_t>& cells, int w, int h);
+
+private:
+  // a live cell of one component, in grid coordinates
+  struct Cell
+  {
+    uint32_t component;
+    int x;
+    int y;
+  };
+
+  // labels the live cells, fills m_cells sorted by component and returns
+  // the number of components
+  uint32_t label(const std::vector<uint8_t>& cells, const ivec2& gridSize);
+
+  std::map<std::string, uint64_t> m_counts;
+  uint64_t m_objects = 0;
+  // the cells of an object, as the key its boxes build, to its apgcode
+  std::unordered_map<std::string, std::string> m_known;
+  // reused between grids
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_root;
+  std::vector<Cell> m_cells;
+};
+
+} // namespace ge
+
+#endif // CENSUS_HPP_
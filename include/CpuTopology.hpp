@@ -0,0 +1,36 @@
+//
+// CpuTopology.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef CPUTOPOLOGY_HPP_
+#define CPUTOPOLOGY_HPP_
+
+#include <vector>
+
+namespace ge
+{
+
+namespace CpuTopology
+{
+
+// CPUs this process may run on (its affinity mask, which is also the
+// container's cpuset), ordered by NUMA node so neighbouring entries
+// share a node; empty where the system does not say
+std::vector<int> usableCpus();
+// CPUs' worth of time the cgroup CPU quota allows, rounded up; 0 without
+// a quota
+int quotaCpus();
+// threads worth running: the usable CPUs, capped by the quota
+int workerCount();
+// binds the calling thread to `cpu`
+bool pinThread(int cpu);
+
+} // namespace CpuTopology
+
+} // namespace ge
+
+#endif // CPUTOPOLOGY_HPP_
@@ -0,0 +1,37 @@
+//
+// Deflate.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef DEFLATE_HPP_
+#define DEFLATE_HPP_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace ge
+{
+
+namespace Deflate
+{
+
+// Appends `data` as a self-contained run of deflate blocks (LZ77 over a
+// 32K window, fixed Huffman codes). Unless `last`, the run ends with an
+// empty stored block so runs compressed separately can be concatenated.
+void compress(const uint8_t* data, size_t size, bool last,
+    std::vector<uint8_t>& out);
+
+uint32_t adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+// adler32 of A + B from adler32(A), adler32(B) and B's length
+uint32_t adler32Combine(uint32_t adlerA, uint32_t adlerB, uint64_t sizeB);
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+} // namespace Deflate
+
+} // namespace ge
+
+#endif // DEFLATE_HPP_
@@ -0,0 +1,163 @@
+//
+// DensityPyramid.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef DENSITYPYRAMID_HPP_
+#define DENSITYPYRAMID_HPP_
+
+#include "Vector.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace ge
+{
+
+// Live cell counts per 2x2, 4x4, ... block of the grid. Level k holds one
+// count per 2^k x 2^k block. Only tiles marked as changed are recounted,
+// from the lists of marked tiles, so an update costs the changed tiles
+// and not the grid.
+class DensityPyramid
+{
+public:
+  static constexpr int TileShift = 4;
+  static constexpr int TileSize = 1 << TileShift;
+
+  void init(const ivec2& gridSize);
+  void markAllChanged();
+
+  // called by the simulation kernels on any worker: the first to mark a
+  // tile adds it to `marked`, that worker's own list, so no tile is listed
+  // twice and nothing is shared but the flag
+  void markChanged(int x, int y, std::vector<uint32_t>& marked)
+  {
+    const uint32_t t = static_cast<uint32_t>(y >> TileShift) * m_tiles.w
+      + (x >> TileShift);
+    if (!m_dirty[t].load(std::memory_order_relaxed)
+        && !m_dirty[t].exchange(1, std::memory_order_relaxed))
+      marked.push_back(t);
+  }
+  // hands a worker's marked tiles over to the next update and empties
+  // the list
+  void takeChanged(std::vector<uint32_t>& marked);
+
+  // recounts the marked tiles and the blocks above them; row(x, y) points
+  // at the cells of row y from column x to the end of the tile, one byte
+  // each, 1 for a live cell and 0 otherwise
+  template <typename Row>
+  void update(const Row& row);
+
+  int levels() const { return static_cast<int>(m_levels.size()); }
+  ivec2 tiles() const { return m_tiles; }
+  // the tiles the last update recounted, row-major
+  const std::vector<uint32_t>& changedTiles() const { return m_updated; }
+  // share of the tiles the last update found changed
+  double changedFraction() const;
+  ivec2 levelSize(int level) const { return m_sizes[level - 1]; }
+
+  const uint32_t* row(int level, int y) const
+  {
+    return m_levels[level - 1].data()
+      + static_cast<size_t>(y) * m_sizes[level - 1].w;
+  }
+
+private:
+  void sumChildren(int level, int x, int y);
+  void propagate();
+
+  ivec2 m_gridSize;
+  ivec2 m_tiles;
+  // per tile, set while the tile is waiting in m_pending
+  std::vector<std::atomic<uint8_t>> m_dirty;
+  std::vector<uint32_t> m_pending;
+  std::vector<uint32_t> m_updated;
+  std::vector<ivec2> m_changedTiles;
+  size_t m_changedCount;
+  std::vector<std::vector<uint32_t>> m_levels;
+  std::vector<ivec2> m_sizes;
+};
+
+template <typename Row>
+void DensityPyramid::update(const Row& row)
+{
+  m_changedTiles.clear();
+  m_changedCount = m_pending.size();
+  // row-major, so the counts are written in order and propagate() sorts
+  // sorted blocks; when most tiles changed the flags are cheaper to scan
+  // than the list is to sort
+  if (m_pending.size() * 8 > m_dirty.size())
+  {
+    m_pending.clear();
+    for (size_t t = 0; t < m_dirty.size(); ++t)
+    {
+      if (m_dirty[t].load(std::memory_order_relaxed))
+        m_pending.push_back(static_cast<uint32_t>(t));
+    }
+  }
+  else
+  {
+    std::sort(m_pending.begin(), m_pending.end());
+  }
+  for (uint32_t t : m_pending)
+  {
+    m_dirty[t].store(0, std::memory_order_relaxed);
+  }
+  // a single cell has no blocks to count
+  const int tileLevels = MIN(TileShift, levels());
+  for (size_t k = 0; k < m_pending.size() && levels() > 0; ++k)
+  {
+    const int tx = static_cast<int>(m_pending[k] % m_tiles.w);
+    const int ty = static_cast<int>(m_pending[k] / m_tiles.w);
+    m_changedTiles.emplace_back(tx, ty);
+
+    const int x0 = tx * TileSize;
+    const int x1 = MIN(x0 + TileSize, m_gridSize.w);
+    const int y0 = ty * TileSize;
+    const int y1 = MIN(y0 + TileSize, m_gridSize.h);
+    uint32_t* level1 = m_levels[0].data();
+    for (int y = y0; y < y1; y += 2)
+    {
+      const uint8_t* top = row(x0, y);
+      const uint8_t* bottom = y + 1 < y1 ? row(x0, y + 1) : nullptr;
+      for (int x = x0; x < x1; x += 2)
+      {
+        const int i = x - x0;
+        uint32_t count = top[i];
+        if (x + 1 < x1) count += top[i + 1];
+        if (bottom)
+        {
+          count += bottom[i];
+          if (x + 1 < x1) count += bottom[i + 1];
+        }
+        level1[static_cast<size_t>(y >> 1) * m_sizes[0].w + (x >> 1)] =
+          count;
+      }
+    }
+
+    for (int level = 2; level <= tileLevels; ++level)
+    {
+      const ivec2 size = m_sizes[level - 1];
+      const int shift = TileShift - level;
+      for (int y = ty << shift; y < MIN((ty + 1) << shift, size.h); ++y)
+      {
+        for (int x = tx << shift; x < MIN((tx + 1) << shift, size.w); ++x)
+        {
+          sumChildren(level, x, y);
+        }
+      }
+    }
+  }
+  m_updated.swap(m_pending);
+  m_pending.clear();
+  propagate();
+}
+
+} // namespace ge
+
+#endif // DENSITYPYRAMID_HPP_
@@ -0,0 +1,51 @@
+//
+// FadeTrails.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef FADETRAILS_HPP_
+#define FADETRAILS_HPP_
+
+#include "Vector.hpp"
+#include "ShaderProgram.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace ge
+{
+
+// Fade trails kept on the GPU: an RG8 accumulation texture in the layout
+// of GpuSimulator's state (r: alive, g: fade counter) that loses one fade
+// grade per generation by blending, with the live cells stamped on top.
+// The simulation only has to provide which cells are alive.
+class FadeTrails
+{
+public:
+  void init(ivec2 gridSize, int fadeGrades);
+  void quit();
+  bool initialized() const { return m_texture != 0; }
+
+  // advances the trails by `generations` and stamps `alive`, one byte per
+  // cell, non-zero for live cells
+  void accumulate(const uint8_t* alive, uint64_t generations);
+
+  uint32_t texture() const { return m_texture; }
+
+private:
+  ivec2 m_gridSize;
+  int m_fadeGrades;
+  ShaderProgram m_program;
+  uint32_t m_texture = 0;
+  uint32_t m_framebuffer;
+  uint32_t m_alive;
+  uint32_t m_vao;
+  int m_decayLocation;
+};
+
+} // namespace ge
+
+#endif // FADETRAILS_HPP_
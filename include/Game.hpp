@@ -12,6 +12,7 @@
 #include "Vector.hpp"
 #include "StateStack.hpp"
 #include "GameContext.hpp"
+#include "Capture.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -25,6 +26,22 @@ enum class Key
 {
   Pause,
   Restart,
+  PanLeft,
+  PanRight,
+  PanUp,
+  PanDown,
+  ZoomIn,
+  ZoomOut,
+  ResetView,
+  Capture,
+  Poster,
+  VirtualTexture,
+  FadeTrails,
+  History,
+  Rewind,
+  Engine,
+  AutoReseed,
+  Count
 };
 
 class Game
@@ -34,18 +51,51 @@ public:
   ~Game();
 
   int run();
+  // renders `frames` frames without a window and optionally saves the last;
+  // the GPU engine is checked against the CPU engine every generation and
+  // a difference fails the run
+  int runOffscreen(int frames, std::string_view snapshot,
+      std::string_view capture = "", bool software = false);
+  // runs the CPU engine for `generations` without a window, then exports
+  // the grid as a PNG at `scale` pixels per cell
+  int runPoster(uint64_t generations, int scale, std::string_view filename);
+  // times every CPU engine on the same headless grid and checks that
+  // they agree
+  int runBenchmark(ivec2 gridSize, uint64_t generations);
+  // runs `soups` random soups with seeds 1, 2, ... for `generations`
+  // each, skipping ahead once a soup repeats, and sums up how they settled
+  // and the objects they settled into
+  int runSoak(ivec2 gridSize, uint64_t soups, uint64_t generations);
+  // runs a bit-packed grid without a window or fades, for grids of many
+  // billions of cells; with a filename the grid lives in that file and
+  // continues from it when it already holds a grid of this size
+  int runHeadless(ivec2 gridSize, uint64_t generations, uint64_t seed,
+      std::string_view filename = "");
   void init();
   void update(const float delta);
+  bool updateCamera(const float delta);
+  void toggleCapture();
 
   static bool isKeyJustPressed(Key code);
+  static bool isKeyDown(Key code);
   static GameContext Context;
   static vec2 getMousePosition();
 
 private:
+  ivec2 configure();
+  void setupView(ivec2 gridSize);
+
   GLFWwindow* m_window;
   std::string m_title;
   ivec2 m_size, m_tileSize;
   StateStack m_stack;
+  StateId m_simulator;
+  Capture m_capture;
+  uint64_t m_drawnGeneration;
+
+  static constexpr float PanSpeed = 800.f; // pixels per second
+  static constexpr float ZoomStep = 1.1f;  // per scroll notch
+  static constexpr float ZoomRate = 4.f;   // per second while a key is held
 };
 
 struct KeyState
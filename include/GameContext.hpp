@@ -10,6 +10,9 @@
 #define GAMECONTEXT_HPP_
 
 #include "Vector.hpp"
+#include "Camera.hpp"
+
+#include <cstdint>
 
 namespace ge
 {
@@ -21,6 +24,12 @@ struct GameContext
   StateStack* StateStack;
   ivec2 GridSize;
   int Side;
+  Camera View;
+  // bumped by the simulator whenever the displayed grid changes
+  uint64_t Generation;
+  bool Paused;
+  // random fill seed, 0 draws one from std::random_device
+  uint32_t Seed;
 };
 
 } // namespace ge
@@ -0,0 +1,55 @@
+//
+// GpuSimulator.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef GPUSIMULATOR_HPP_
+#define GPUSIMULATOR_HPP_
+
+#include "State.hpp"
+#include "Vector.hpp"
+#include "GameContext.hpp"
+#include "ShaderProgram.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace ge
+{
+
+// Keeps the grid in two RG8 textures (r: alive, g: fade counter) and
+// advances it by rendering one into the other through shaders/life.frag.
+class GpuSimulator : public State
+{
+public:
+  GpuSimulator(GameContext& context);
+  ~GpuSimulator();
+
+  bool update(const float delta) override;
+  void draw() override;
+
+  void step();
+  // copies the current generation back, two bytes per cell
+  void readState(std::vector<uint8_t>& state) const;
+  void writeState(const std::vector<uint8_t>& state);
+
+private:
+  void fillWithRandom();
+
+  ivec2 m_gridSize;
+  bool m_resetRequested;
+  int m_accum;
+
+  ShaderProgram m_program;
+  uint32_t m_textures[2];
+  uint32_t m_framebuffers[2];
+  uint32_t m_vao;
+  int m_current;
+};
+
+} // namespace ge
+
+#endif // GPUSIMULATOR_HPP_
@@ -0,0 +1,103 @@
+//
+// GridBuffer.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef GRIDBUFFER_HPP_
+#define GRIDBUFFER_HPP_
+
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace ge
+{
+
+namespace GridMemory
+{
+
+constexpr size_t HugePageSize = size_t(2) << 20;
+constexpr size_t Alignment = 64;
+
+// maps at least `bytes` of memory aligned to Alignment, backed by huge
+// pages where the system has them; `mapped` receives the mapped size
+void* map(size_t bytes, size_t& mapped);
+void unmap(void* memory, size_t mapped);
+// calls fill(begin, end) for HugePageSize byte ranges of [0, bytes), each
+// worker filling one contiguous band in order, so a page is first touched
+// on the node of the worker whose band it is in
+void fillChunks(size_t bytes, const std::function<void(size_t, size_t)>& fill);
+
+} // namespace GridMemory
+
+// A grid-sized array in its own mapping. assign() keeps the mapping
+// when it is large enough, so restarting a grid only refills it.
+template <typename T>
+class GridBuffer
+{
+public:
+  GridBuffer() = default;
+  ~GridBuffer() { release(); }
+  GridBuffer(const GridBuffer&) = delete;
+  GridBuffer& operator=(const GridBuffer&) = delete;
+
+  // `count` elements set to `value`, filled in parallel
+  void assign(size_t count, T value);
+  void release();
+  void swap(GridBuffer& other);
+
+  T* data() { return m_data; }
+  const T* data() const { return m_data; }
+  size_t size() const { return m_size; }
+  T& operator[](size_t i) { return m_data[i]; }
+  const T& operator[](size_t i) const { return m_data[i]; }
+
+private:
+  T* m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_mapped = 0;
+};
+
+template <typename T>
+void GridBuffer<T>::assign(size_t count, T value)
+{
+  static_assert(GridMemory::HugePageSize % sizeof(T) == 0);
+  const size_t bytes = count * sizeof(T);
+  if (bytes > m_mapped)
+  {
+    release();
+    m_data = static_cast<T*>(GridMemory::map(bytes, m_mapped));
+  }
+  m_size = count;
+  T* data = m_data;
+  GridMemory::fillChunks(bytes, [data, value](size_t begin, size_t end) {
+    std::fill(data + begin / sizeof(T), data + end / sizeof(T), value);
+  });
+}
+
+template <typename T>
+void GridBuffer<T>::release()
+{
+  if (m_data)
+    GridMemory::unmap(m_data, m_mapped);
+  m_data = nullptr;
+  m_size = 0;
+  m_mapped = 0;
+}
+
+template <typename T>
+void GridBuffer<T>::swap(GridBuffer& other)
+{
+  std::swap(m_data, other.m_data);
+  std::swap(m_size, other.m_size);
+  std::swap(m_mapped, other.m_mapped);
+}
+
+} // namespace ge
+
+#endif // GRIDBUFFER_HPP_
@@ -0,0 +1,54 @@
+//
+// GridStats.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef GRIDSTATS_HPP_
+#define GRIDSTATS_HPP_
+
+#include "Vector.hpp"
+
+#include <climits>
+#include <cstdint>
+
+namespace ge
+{
+
+// Counts of a grid after a pass, gathered by the kernels while they write
+// the cells: every band keeps its own and they are merged once the pass
+// is done, instead of reading the grid again.
+struct GridStats
+{
+  uint64_t population = 0;
+  // cells that came alive and died over the pass
+  uint64_t births = 0;
+  uint64_t deaths = 0;
+  // the smallest rectangle holding every live cell, corners included;
+  // min is past max while there is none
+  ivec2 min = { INT_MAX, INT_MAX };
+  ivec2 max = { INT_MIN, INT_MIN };
+
+  bool empty() const { return min.x > max.x; }
+
+  void include(int x0, int y0, int x1, int y1)
+  {
+    min = { MIN(min.x, x0), MIN(min.y, y0) };
+    max = { MAX(max.x, x1), MAX(max.y, y1) };
+  }
+
+  void merge(const GridStats& other)
+  {
+    population += other.population;
+    births += other.births;
+    deaths += other.deaths;
+    if (!other.empty())
+      include(other.min.x, other.min.y, other.max.x, other.max.y);
+  }
+};
+
+} // namespace ge
+
+#endif // GRIDSTATS_HPP_
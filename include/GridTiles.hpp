@@ -0,0 +1,149 @@
+//
+// GridTiles.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef GRIDTILES_HPP_
+#define GRIDTILES_HPP_
+
+#include "Vector.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+namespace ge
+{
+
+// Storage order of the per-cell arrays: row-major tiles of TileSize x
+// TileSize cells, the tiles themselves in Z (Morton) order. The rows above
+// and below a cell are one tile row away instead of a grid row, and tiles
+// close in the grid stay close in memory. Edge tiles are padded, so a
+// grid takes cellCount() entries.
+class GridTiles
+{
+public:
+  static constexpr int TileShift = 6;
+  static constexpr int TileSize = 1 << TileShift;
+  static constexpr size_t TileCells = TileSize * TileSize;
+
+  struct Tile
+  {
+    ivec2 origin; // first cell of the tile in the grid
+    ivec2 size;   // cells inside the grid, less at the right and bottom
+    size_t base;  // index of the first cell
+  };
+
+  void init(const ivec2& gridSize);
+
+  const ivec2& gridSize() const { return m_gridSize; }
+  int tileCount() const { return static_cast<int>(m_tiles.size()); }
+  size_t cellCount() const { return m_tiles.size() * TileCells; }
+  // tiles in storage order
+  const Tile& tile(int i) const { return m_tiles[i]; }
+
+  size_t index(int x, int y) const
+  {
+    return m_base[static_cast<size_t>(y >> TileShift) * m_columns
+      + (x >> TileShift)]
+      + ((y & (TileSize - 1)) << TileShift) + (x & (TileSize - 1));
+  }
+
+  // storage order position of the tile holding cell (x, y)
+  int tileAt(int x, int y) const
+  {
+    return static_cast<int>(m_base[static_cast<size_t>(y >> TileShift)
+        * m_columns + (x >> TileShift)] / TileCells);
+  }
+
+  // index of a cell one step outside the grid, wrapped around the torus
+  size_t wrappedIndex(int x, int y) const
+  {
+    x = x < 0 ? x + m_gridSize.w : x >= m_gridSize.w ? x - m_gridSize.w : x;
+    y = y < 0 ? y + m_gridSize.h : y >= m_gridSize.h ? y - m_gridSize.h : y;
+    return index(x, y);
+  }
+
+  // calls run(cell, index, count) for every stretch of a row that lies in
+  // one tile, covering the cells [begin, end) tile by tile
+  template <typename Run>
+  void forEachRun(ivec2 begin, ivec2 end, Run&& run) const;
+
+  // `count` cells of row y from column x, wrapping around the torus
+  template <typename T>
+  void readRow(const T* cells, int x, int y, int count, T* dst) const;
+  // `count` cells of row y from column x, inside the grid
+  template <typename T>
+  void writeRow(T* cells, int x, int y, int count, const T* src) const;
+  // the whole grid row by row
+  template <typename T>
+  void toRows(const T* cells, T* rows) const;
+
+private:
+  ivec2 m_gridSize;
+  int m_columns;
+  std::vector<Tile> m_tiles;
+  std::vector<size_t> m_base; // per tile, row-major
+};
+
+template <typename Run>
+void GridTiles::forEachRun(ivec2 begin, ivec2 end, Run&& run) const
+{
+  if (begin.x >= end.x || begin.y >= end.y)
+    return;
+  for (int ty = begin.y >> TileShift; ty <= (end.y - 1) >> TileShift; ++ty)
+  {
+    const int y0 = MAX(begin.y, ty << TileShift);
+    const int y1 = MIN(end.y, (ty + 1) << TileShift);
+    for (int tx = begin.x >> TileShift; tx <= (end.x - 1) >> TileShift; ++tx)
+    {
+      const int x0 = MAX(begin.x, tx << TileShift);
+      const int count = MIN(end.x, (tx + 1) << TileShift) - x0;
+      for (int y = y0; y < y1; ++y)
+      {
+        run(ivec2(x0, y), index(x0, y), count);
+      }
+    }
+  }
+}
+
+template <typename T>
+void GridTiles::readRow(const T* cells, int x, int y, int count, T* dst) const
+{
+  x = ((x % m_gridSize.w) + m_gridSize.w) % m_gridSize.w;
+  while (count > 0)
+  {
+    const int n = MIN(count, m_gridSize.w - x);
+    forEachRun({ x, y }, { x + n, y + 1 }, [&](ivec2, size_t i, int k) {
+      std::memcpy(dst, cells + i, k * sizeof(T));
+      dst += k;
+    });
+    count -= n;
+    x = 0;
+  }
+}
+
+template <typename T>
+void GridTiles::writeRow(T* cells, int x, int y, int count, const T* src) const
+{
+  forEachRun({ x, y }, { x + count, y + 1 }, [&](ivec2, size_t i, int k) {
+    std::memcpy(cells + i, src, k * sizeof(T));
+    src += k;
+  });
+}
+
+template <typename T>
+void GridTiles::toRows(const T* cells, T* rows) const
+{
+  forEachRun({ 0, 0 }, m_gridSize, [&](ivec2 cell, size_t i, int count) {
+    std::memcpy(rows + static_cast<size_t>(cell.y) * m_gridSize.w + cell.x,
+        cells + i, count * sizeof(T));
+  });
+}
+
+} // namespace ge
+
+#endif // GRIDTILES_HPP_
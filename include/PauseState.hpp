@@ -18,6 +18,7 @@ class PauseState : public State
 {
 public:
   PauseState(GameContext& context);
+  ~PauseState();
 
   bool update(const float) override;
   void draw() override;
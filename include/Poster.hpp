@@ -0,0 +1,40 @@
+//
+// Poster.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef POSTER_HPP_
+#define POSTER_HPP_
+
+#include "Vector.hpp"
+
+#include <string_view>
+#include <functional>
+#include <vector>
+
+namespace ge
+{
+
+namespace Poster
+{
+
+// Appends the quads of grid rows [y0, y1) in the layout Render::fillRect
+// takes. Called from several worker threads at once.
+using StripSource = std::function<void(int y0, int y1,
+    std::vector<vec2>& translations, std::vector<vec4>& colors)>;
+
+// Renders the whole grid at `scale` pixels per cell into an RGB PNG.
+// Horizontal strips are rasterized and deflated in parallel and streamed
+// to disk in order, so memory stays bounded by a few strips per worker
+// whatever the size of the image.
+bool writePNG(std::string_view filename, ivec2 gridSize, int scale,
+    float quadSize, const StripSource& source);
+
+} // namespace Poster
+
+} // namespace ge
+
+#endif // POSTER_HPP_
@@ -12,6 +12,8 @@
 #include <string_view>
 #include <string>
 #include <optional>
+#include <vector>
+#include <cstdint>
 
 namespace ge
 {
@@ -20,6 +22,9 @@ namespace File
 {
 
 std::optional<std::string> read(std::string_view filename);
+// binary PPM from top-down RGBA rows, alpha is dropped
+bool writePPM(std::string_view filename, int width, int height,
+    const std::vector<uint8_t>& rgba);
 
 } // namespace File
 
@@ -14,19 +14,52 @@
 
 #include "Vector.hpp"
 
+#include <vector>
+#include <string>
+#include <cstdint>
+
 namespace ge
 {
 
+class Capture;
+class VirtualTexture;
+
 class Render
 {
 public:
   static bool Init(GLFWwindow** window, const std::string& title, ivec2 size, ivec2 tileSize);
+  // no window: EGL surfaceless or OSMesa context drawing into a framebuffer
+  static bool InitOffscreen(ivec2 size);
+  // no GL: begin/fillRect/end rasterize into a CPU framebuffer
+  static bool InitSoftware(ivec2 size);
   static void Quit();
+  // pos is in grid cells; quads are sized by setQuadSize
   static void fillRect(vec2 pos, vec4 color);
+  static void setQuadSize(float cells);
+
+  // draws an RG8 state texture (r: alive, g: fade) through the camera
+  static void drawGrid(uint32_t stateTexture, ivec2 gridSize);
+  static void setGridPalette(const std::vector<vec4>& colors);
+  // draws the resident pages of `texture`, updated for the current camera
+  static void drawVirtual(const VirtualTexture& texture);
+  // true when frames are rasterized on the CPU and textures are unavailable
+  static bool isSoftware();
+
+  // framebuffer frames are drawn into, 0 unless offscreen
+  static uint32_t targetFramebuffer();
+  // last frame as top-down RGBA rows
+  static void readPixels(std::vector<uint8_t>& rgba);
+  static ivec2 getSize();
+  // every presented frame is handed to `capture` before the swap
+  static void setCapture(Capture* capture);
+
+  // fraction of a cell covered by its quad, leaving a visible gap
+  static constexpr float CellQuadSize = 0.7f;
 
 private:
   static void begin();
   static void end();
+  static void present();
 
 private:
   friend class Game;
@@ -10,6 +10,7 @@
 #define SHADERPROGRAM_HPP_
 
 #include <string_view>
+#include <cstdint>
 
 namespace ge
 {
@@ -19,6 +20,10 @@ class ShaderProgram
 public:
   ShaderProgram();
 
+  // enables the program binary cache in shaders/cache when the driver
+  // supports GL_ARB_get_program_binary, needs a current context
+  static void initBinaryCache(void* (*loader)(const char*));
+  // loads the cached binary for these sources and driver, else compiles
   void load(std::string_view vertFilename, std::string_view fragFilename);
 
   void quit();
@@ -12,9 +12,17 @@
 #include "State.hpp"
 #include "Vector.hpp"
 #include "GameContext.hpp"
+#include "DensityPyramid.hpp"
+#include "VirtualTexture.hpp"
+#include "FadeTrails.hpp"
+#include "GridTiles.hpp"
+#include "GridBuffer.hpp"
+#include "AdaptiveEngine.hpp"
+#include "GridStats.hpp"
 
 #include <vector>
 #include <array>
+#include <string_view>
 
 namespace ge
 {
@@ -22,43 +30,240 @@ namespace ge
 class Simulator : public State
 {
 public:
+  enum class Engine
+  {
+    Banded,          // one generation per pass over the active tiles
+    TemporalBlocked, // TemporalDepth generations per pass over tiles
+    InPlace,         // one grid, rolling row buffers per band
+    Adaptive,        // banded or temporal, whichever suits the grid
+  };
+  static constexpr int EngineCount = 4;
+
+  // what step() does once the grid repeats a state
+  enum class OnCycle
+  {
+    Report,      // logs it
+    FastForward, // also skips whole periods up to a target generation
+    Reseed,      // logs it and starts the next soup
+  };
+
   Simulator(GameContext& context);
+  ~Simulator();
 
   bool update(const float delta) override;
   void draw() override;
 
+  // advances the grid by one pass of the current engine
+  void step();
+  void setEngine(Engine engine);
+  Engine engine() const { return m_adaptive ? Engine::Adaptive : m_engine; }
+  // counts of the last pass, from the kernels; births and deaths of a
+  // temporal pass are its net changes over TemporalDepth generations
+  const GridStats& stats() const { return m_stats; }
+  uint64_t population() const { return m_stats.population; }
+
+  void setOnCycle(OnCycle action, uint64_t fastForwardTo = 0);
+  // XOR of the Zobrist keys of the live cells
+  uint64_t gridHash() const { return m_gridHash; }
+  // once the grid repeats: its period and the first generation of the
+  // cycle; both 0 before. The temporal engine is only seen every
+  // TemporalDepth generations, so with it they are multiples of that.
+  uint64_t cyclePeriod() const { return m_cyclePeriod; }
+  uint64_t stableSince() const { return m_stableSince; }
+  // copies the current generation row by row, one byte per cell
+  void snapshot(std::vector<uint8_t>& rows) const;
+  // replaces the current generation with row-major bytes, non-zero for
+  // live cells, as snapshot() writes them
+  void load(const std::vector<uint8_t>& rows);
+
+  // writes the whole grid as a PNG at `scale` pixels per cell, styled
+  // like draw() when zoomed in
+  bool exportPoster(std::string_view filename, const int scale) const;
+
+  // history mode keeps each cell's last History states for fades,
+  // period detection and rewind
+  void setHistoryMode(bool enabled);
+  // steps back up to History - 1 recorded generations
+  bool rewind(int generations);
+  // smallest period seen over the recorded states, 0 if none
+  int cellPeriod(int x, int y) const;
+  int gridPeriod() const;
+
+  static std::vector<vec4> fadePalette();
+
+  static constexpr int InitCellsCountPercentage = 16;
+  static constexpr int FadeGrades = 60;
+  static constexpr int UpdateEvery = 3;
+  // generations between sweeps that keep wrapped death stamps old
+  static constexpr uint64_t StampRefreshPeriod = 1 << 14;
+  static constexpr int History = 64;
+  // grid hashes of the last passes searched for a repeat; a cycle is only
+  // found while two of its states are in there, so its period is at most
+  // HashHistory passes
+  static constexpr int HashHistory = 1024;
+  // banded engine: tasks a worker's band of active tiles is cut into, so
+  // there is something left to steal from the busy bands
+  static constexpr int TasksPerWorker = 8;
+  // a tile and its halo stay in L2 for all TemporalDepth generations
+  static constexpr int TemporalTile = 128;
+  static constexpr int TemporalDepth = 8;
+
 private:
   void init(const ivec2& gridSize, const int side);
   void reset();
   void fillWithRandom();
   void initFadeColors();
 
-  void calculateNext(const size_t begin, const size_t end);
-  void swapArrays();
-
-  struct Cell
+  // switches the engine that runs the passes, never Adaptive
+  void useEngine(Engine engine);
+  // feeds a pass to m_adaptiveEngine and follows its choice
+  void adapt(const int generations, const double seconds);
+  // what one band of a pass adds up while it writes its cells
+  struct alignas(64) BandStats
   {
-    int value;
-    int fade;
+    GridStats stats;
+    uint64_t hash = 0; // keys of the changed cells
+    // density pyramid tiles this band marked changed first
+    std::vector<uint32_t> changedTiles;
   };
 
-  std::vector<Cell> m_cells1;
-  std::vector<Cell> m_cells2;
-  std::vector<int> m_calcs;
+  void calculateNext(const int* tiles, const int count, BandStats& band);
+  // fills m_activeTiles for the next banded pass
+  void findActiveTiles();
+  // cuts m_activeTiles into m_taskStarts, every worker's tasks inside its
+  // own storage band, where its memory was first touched
+  void cutTasks(const int workers);
+  void advanceTile(const int x0, const int y0, const int depth,
+      BandStats& band);
+  void advanceInPlace();
+  void advanceRow(const uint8_t* up, const uint8_t* mid, const uint8_t* down,
+      uint8_t* out, const int y, BandStats& band);
+  // `count` empty band slots, keeping the capacity of their lists
+  void resetBandStats(size_t count);
+  // merges m_bandStats into m_stats and the grid hash, and hands their
+  // changed tiles to the pyramid
+  void mergeStats();
+  // population and bounding box from the per-tile counts
+  void addTileStats(GridStats& stats) const;
+  // recounts the changed tiles and stamps their pages, once the generation
+  // is that of the cells
+  void updatePyramid();
+  void drawAggregated(const int block);
+  bool fillPage(int level, ivec2 page, uint8_t* texels) const;
+  uint64_t pageStamp(int level, ivec2 page) const;
+  // the cells of level 0 page (x, y) changed in this generation
+  void stampPage(int x, int y);
+  // every texel changed in this generation, cells or fades
+  void stampAllPages();
+  void drawTrails();
+  template <typename Emit>
+  void forEachCell(ivec2 begin, ivec2 end, Emit&& emit) const;
+  void swapArrays();
+
+  // fade grade of dead cell i, 0 once its fade is over
+  int fadeAt(size_t i) const;
+  uint16_t longDead() const;
+  void refreshDeathStamps();
+  void startHistory();
+  uint64_t periodMask(int period) const;
+  void logPeriod();
+  // hashes and counts the whole grid and forgets the cycle search so far
+  void rescan();
+  // looks the new grid hash up in m_hashHistory, and once the cells of a
+  // repeat come back after its period, acts on it
+  void trackCycle();
+
+  // every per-cell array is in m_tiles order
+  GridTiles m_tiles;
+  // one byte per cell, 1 alive, 0 dead
+  GridBuffer<uint8_t> m_cells1;
+  GridBuffer<uint8_t> m_cells2;
+  // banded engine: the eight tiles around each tile, in storage order
+  std::vector<std::array<int, 8>> m_tileNeighbours;
+  // whether a tile's cells changed in the last banded pass; a tile with
+  // no change in or around it has both arrays equal and is skipped
+  std::vector<uint8_t> m_tileChanged;
+  // m_tileChanged describes the arrays; anything else that writes them
+  // clears this and the next pass computes every tile
+  bool m_activityKnown;
+  std::vector<int> m_activeTiles;
+  // the first active tile of each task, then the end of m_activeTiles
+  std::vector<int> m_taskStarts;
+  // the first task of each worker's band, then the task count
+  std::vector<int> m_workerTasks;
+  // temporal engine: tile origins in storage order, split into one band
+  // per worker like the memory
+  std::vector<ivec2> m_temporalTiles;
+  // in-place engine: the first and last row of each band before a pass
+  std::vector<uint8_t> m_boundaryRows;
+  // low 16 bits of the generation each cell last died in; the fade is
+  // the age against the current generation, so only deaths write here
+  GridBuffer<uint16_t> m_deathGen;
+  // history mode: one shift register per cell, newest state in the top
+  // bit, replacing the stamps
+  GridBuffer<uint64_t> m_history;
+
+  // row-major copy of the cells for texture uploads
+  std::vector<uint8_t> m_rows;
 
   std::vector<vec4> m_fadeColors;
+  DensityPyramid m_pyramid;
+  VirtualTexture m_virtual;
+  // per virtual texture level, the generation each page last changed in;
+  // a page holds the latest of the pages under it
+  std::vector<std::vector<uint64_t>> m_pageStamps;
+  std::vector<ivec2> m_pageCounts;
+  FadeTrails m_trails;
+  uint64_t m_trailGeneration;
 
   ivec2 m_gridSize;
   int m_side;
   bool m_pause;
   bool m_resetRequested;
+  // draw through m_virtual instead of instanced quads
+  bool m_virtualTexturing;
+  // fades are blended on the GPU by m_trails, the kernel skips them
+  bool m_gpuTrails;
+  bool m_historyMode;
+  int m_historyDepth; // recorded generations, at most History
+  int m_period;
+  // the engine running the passes; with m_adaptive set it is picked by
+  // m_adaptiveEngine
+  Engine m_engine;
+  bool m_adaptive;
+  AdaptiveEngine m_adaptiveEngine;
+  int m_accum;
+  uint64_t m_stampRefresh;
   int m_actualFades;
 
-  Cell* m_currentArray;
-  Cell* m_nextArray;
-  static constexpr int InitCellsCountPercentage = 16;
-  static constexpr int FadeGrades = 60;
-  static constexpr int UpdateEvery = 3;
+  uint16_t m_stepStamp;
+
+  // kept up by the engines from the cells they change in a pass
+  uint64_t m_gridHash;
+  std::vector<BandStats> m_bandStats;
+  GridStats m_stats;
+  // per storage tile, kept by the banded and temporal passes: live cells
+  // and a bit for each row and column of the tile holding any
+  std::vector<uint32_t> m_tileLive;
+  std::vector<uint64_t> m_tileRows;
+  std::vector<uint64_t> m_tileCols;
+  // (generation, hash) of recent passes; once full, m_hashNext is the
+  // oldest and overwritten next
+  std::vector<std::pair<uint64_t, uint64_t>> m_hashHistory;
+  size_t m_hashNext;
+  uint64_t m_cyclePeriod;
+  uint64_t m_stableSince;
+  // a hash repeat waiting to be confirmed: the cells at m_candidateAt, to
+  // be compared once m_candidatePeriod more generations have run
+  uint64_t m_candidatePeriod;
+  uint64_t m_candidateSince;
+  uint64_t m_candidateAt;
+  std::vector<uint8_t> m_candidateCells;
+  OnCycle m_onCycle;
+  uint64_t m_fastForwardTo;
+
+  uint8_t* m_currentArray;
+  uint8_t* m_nextArray;
 };
 
 } // namespace ge
@@ -0,0 +1,58 @@
+//
+// SoftwareRasterizer.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef SOFTWARERASTERIZER_HPP_
+#define SOFTWARERASTERIZER_HPP_
+
+#include "Vector.hpp"
+#include "Camera.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace ge
+{
+
+// Draws the same instanced quads as the GL path into an RGBA8 framebuffer,
+// following GL's pixel centre coverage rule so the output matches llvmpipe.
+class SoftwareRasterizer
+{
+public:
+  void resize(ivec2 size);
+  void clear(vec4 color);
+  void draw(const std::vector<vec2>& translations,
+      const std::vector<vec4>& colors, float quadSize, const Camera& view);
+
+  ivec2 size() const { return m_size; }
+  // top-down RGBA rows
+  const std::vector<uint32_t>& pixels() const { return m_pixels; }
+
+  // draw() limited to rows [y0, y1) on the calling thread, for callers
+  // that are already running on the worker pool
+  void drawRows(int y0, int y1, const std::vector<vec2>& translations,
+      const std::vector<vec4>& colors, float quadSize, const Camera& view);
+
+  static uint32_t pack(vec4 color);
+  static void fillSpan(uint32_t* dst, int count, uint32_t color);
+
+private:
+  // quad i clipped to rows [y0, y1)
+  void drawQuad(size_t i, int y0, int y1,
+      const std::vector<vec2>& translations, const std::vector<vec4>& colors,
+      float quadSize, const Camera& view);
+
+  ivec2 m_size;
+  std::vector<uint32_t> m_pixels;
+  // draw(): the quads of each band of rows, one list per band and chunk of
+  // the quads, [chunk * bands + band], kept between frames
+  std::vector<std::vector<uint32_t>> m_bins;
+};
+
+} // namespace ge
+
+#endif // SOFTWARERASTERIZER_HPP_
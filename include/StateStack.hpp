@@ -34,6 +34,7 @@ enum class StateChange
 enum class StateId
 {
   Simulator,
+  GpuSimulator,
   PauseState,
   None
 };
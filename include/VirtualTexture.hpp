@@ -0,0 +1,98 @@
+//
+// VirtualTexture.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef VIRTUALTEXTURE_HPP_
+#define VIRTUALTEXTURE_HPP_
+
+#include "Vector.hpp"
+#include "Camera.hpp"
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+namespace ge
+{
+
+// A grid of any size seen through a fixed texture budget. The grid is cut
+// into pages of PageSize x PageSize texels per level; the pages the camera
+// sees are streamed into an atlas with least recently used eviction, and
+// a small indirection table maps the visible window of pages to slots.
+class VirtualTexture
+{
+public:
+  static constexpr int PageShift = 6;
+  static constexpr int PageSize = 1 << PageShift;
+  // slots per atlas side: a 2048 x 2048 RG8 atlas, 8 MB whatever the grid
+  static constexpr int AtlasPages = 32;
+  static constexpr uint16_t NoPage = 0xFFFF;
+
+  // Writes the PageSize x PageSize RG8 texels of `page` at `level`; level 0
+  // holds r: alive, g: fade counter, level k the live fraction of each
+  // 2^k x 2^k block in r. Returns false when every texel is zero.
+  using PageSource = std::function<bool(int level, ivec2 page,
+      uint8_t* texels)>;
+  // The stamp at which the texels of `page` at `level` last changed, at
+  // most the stamp of the current update; a page filled since is kept.
+  using PageStamp = std::function<uint64_t(int level, ivec2 page)>;
+
+  void init(ivec2 gridSize, PageSource source, PageStamp changed);
+  void quit();
+  bool initialized() const { return m_atlas != 0; }
+
+  // makes the pages visible through `view` resident, refilling any that
+  // changed since they were filled, and rebuilds the indirection table
+  void update(const Camera& view, uint64_t stamp);
+
+  uint32_t atlas() const { return m_atlas; }
+  uint32_t indirection() const { return m_indirection; }
+  int level() const { return m_level; }
+  // first page and size in pages of the window the table covers
+  ivec2 windowOrigin() const { return m_windowOrigin; }
+  ivec2 windowSize() const { return m_windowSize; }
+  ivec2 gridSize() const { return m_gridSize; }
+  size_t residentPages() const { return m_resident.size(); }
+
+private:
+  struct Slot
+  {
+    uint64_t key;
+    uint64_t stamp; // the update the texels were filled in
+    std::list<int>::iterator recent;
+  };
+
+  uint16_t requestPage(int level, ivec2 page, uint64_t stamp);
+  int acquireSlot();
+  void releaseSlot(int slot);
+  void upload(int slot);
+
+  ivec2 m_gridSize;
+  PageSource m_source;
+  PageStamp m_changed;
+  uint32_t m_atlas = 0;
+  uint32_t m_indirection = 0;
+  int m_level = 0;
+  ivec2 m_windowOrigin;
+  ivec2 m_windowSize;
+  ivec2 m_tableSize;
+
+  std::vector<Slot> m_slots;
+  std::vector<int> m_freeSlots;
+  std::list<int> m_recent; // front: most recently used
+  std::unordered_map<uint64_t, int> m_resident;
+  // stamp at which a page was last found empty; empty pages take no slot
+  std::unordered_map<uint64_t, uint64_t> m_empty;
+  std::vector<uint8_t> m_texels;
+  std::vector<uint16_t> m_table;
+};
+
+} // namespace ge
+
+#endif // VIRTUALTEXTURE_HPP_
@@ -0,0 +1,86 @@
+//
+// WorkerPool.hpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#ifndef WORKERPOOL_HPP_
+#define WORKERPOOL_HPP_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace ge
+{
+
+// Persistent threads that run batches of indexed tasks. The calling
+// thread takes part in every batch, so a pool of size n has n - 1 threads.
+// A pool sized to the machine has n threads instead, pinned in NUMA node
+// order to the CPUs the process may use, and the caller only waits: it
+// stays unpinned, and so do the threads it starts.
+class WorkerPool
+{
+public:
+  explicit WorkerPool(int size = 0); // 0: one per usable CPU, pinned
+  ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  int size() const;
+  // calls task(i) for every i in [0, count), returns once all have finished
+  void run(int count, const std::function<void(int)>& task);
+  // calls task(worker) once on every worker, the caller being worker 0
+  // unless the pool is pinned; a pinned worker always runs on the same
+  // CPU, so memory it touches first stays on its node
+  void runEach(const std::function<void(int)>& task);
+  // calls task(i, worker) for every i in [0, bands[n]) like run(), but
+  // worker w starts on its own band [bands[w], bands[w + 1]) in order; a
+  // worker out of tasks steals the back half of a random other's band
+  void runStealing(const std::vector<int>& bands,
+      const std::function<void(int, int)>& task);
+
+  static WorkerPool& shared();
+
+private:
+  void workerLoop(int worker, int cpu);
+  void drain();
+  // moves tasks from another worker's band into this one's, false once
+  // no worker has any left
+  bool steal(int worker, uint64_t& random);
+
+  // runStealing: the tasks left to each worker, taken from the front by
+  // their owner and from the back by thieves
+  struct alignas(64) TaskRange
+  {
+    std::mutex mutex;
+    int begin = 0;
+    int end = 0;
+  };
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  const std::function<void(int)>* m_task;
+  int m_count;
+  std::atomic<int> m_next;
+  int m_busy;
+  bool m_each;
+  uint64_t m_batch;
+  bool m_stopping;
+  // the caller is worker 0, for a pool that is not pinned
+  bool m_callerRuns;
+  std::unique_ptr<TaskRange[]> m_ranges;
+};
+
+} // namespace ge
+
+#endif // WORKERPOOL_HPP_
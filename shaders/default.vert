@@ -5,12 +5,16 @@ layout (location = 1) in vec2 aTranslation;
 layout (location = 2) in vec4 aColor;
 
 uniform mat4 projection;
+// xy: grid position of the top left screen corner, z: pixels per cell
+uniform vec3 camera;
+uniform float quadSize;
 
 out vec4 Color;
 
 void main()
 {
-  vec2 translated_pos = aPosition + aTranslation;
+  vec2 translated_pos =
+    (aPosition * quadSize + aTranslation - camera.xy) * camera.z;
   gl_Position = projection * vec4(translated_pos, 0, 1.0);
   Color = aColor;
 }
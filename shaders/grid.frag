@@ -0,0 +1,38 @@
+#version 330 core
+
+in vec2 Cell;
+
+// r: alive, g: fade counter / 255
+uniform sampler2D state;
+uniform sampler2D palette;
+uniform float quadSize;
+// mip level holding one texel per drawn block, 0 while zoomed in
+uniform float lod;
+
+out vec4 FragColor;
+
+void main()
+{
+  if (lod > 0.0)
+  {
+    float density = textureLod(state, Cell / vec2(textureSize(state, 0)), lod).r;
+    if (density <= 0.0)
+      discard;
+    float shade = sqrt(density);
+    FragColor = vec4(shade, shade, shade, 1.0);
+    return;
+  }
+
+  if (any(greaterThanEqual(fract(Cell), vec2(quadSize))))
+    discard;
+  vec2 current = texelFetch(state, ivec2(Cell), 0).rg;
+  if (current.r > 0.5)
+  {
+    FragColor = vec4(1.0);
+    return;
+  }
+  int fade = int(current.g * 255.0 + 0.5);
+  if (fade == 0)
+    discard;
+  FragColor = texelFetch(palette, ivec2(fade - 1, 0), 0);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+
+uniform mat4 projection;
+// xy: grid position of the top left screen corner, z: pixels per cell
+uniform vec3 camera;
+uniform vec2 gridSize;
+
+out vec2 Cell;
+
+// the whole grid as a triangle strip, clipped by the viewport
+void main()
+{
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  Cell = corner * gridSize;
+  gl_Position = projection * vec4((Cell - camera.xy) * camera.z, 0, 1.0);
+}
@@ -0,0 +1,46 @@
+#version 330 core
+
+// r: alive, g: fade counter / 255
+uniform sampler2D state;
+uniform int fadeGrades;
+
+out vec2 NextState;
+
+int alive(ivec2 cell, ivec2 size)
+{
+  return texelFetch(state, (cell + size) % size, 0).r > 0.5 ? 1 : 0;
+}
+
+void main()
+{
+  ivec2 size = textureSize(state, 0);
+  ivec2 cell = ivec2(gl_FragCoord.xy);
+  int calc =
+      alive(cell + ivec2( 1,  0), size)
+    + alive(cell + ivec2(-1,  0), size)
+    + alive(cell + ivec2( 0,  1), size)
+    + alive(cell + ivec2( 0, -1), size)
+    + alive(cell + ivec2( 1,  1), size)
+    + alive(cell + ivec2(-1, -1), size)
+    + alive(cell + ivec2( 1, -1), size)
+    + alive(cell + ivec2(-1,  1), size);
+
+  vec2 current = texelFetch(state, cell, 0).rg;
+  bool live = current.r > 0.5;
+  int fade = int(current.g * 255.0 + 0.5);
+  if ((calc < 2 || calc > 3) && live)
+  {
+    live = false;
+    fade = fadeGrades;
+  }
+  else if (calc == 3 && !live)
+  {
+    live = true;
+    fade = 0;
+  }
+  else
+  {
+    fade = max(fade - 1, 0);
+  }
+  NextState = vec2(live ? 1.0 : 0.0, float(fade) / 255.0);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+// one byte per cell, non-zero for live cells
+uniform sampler2D alive;
+// fade grades removed this pass, 0 for the pass stamping live cells
+uniform float decay;
+uniform float lifeGrade;
+
+out vec4 FragColor;
+
+void main()
+{
+  if (decay > 0.0)
+  {
+    FragColor = vec4(1.0, decay, 0.0, 0.0);
+    return;
+  }
+  if (texelFetch(alive, ivec2(gl_FragCoord.xy), 0).r == 0.0)
+    discard;
+  FragColor = vec4(1.0, lifeGrade, 0.0, 1.0);
+}
@@ -0,0 +1,47 @@
+#version 330 core
+
+in vec2 Cell;
+
+// atlas slot of each page in the window, 0xFFFF for empty pages
+uniform usampler2D indirection;
+// level 0 r: alive, g: fade counter / 255; level k r: live fraction
+uniform sampler2D atlas;
+uniform sampler2D palette;
+uniform float quadSize;
+uniform int level;
+uniform int pageShift;
+uniform int atlasPages;
+
+out vec4 FragColor;
+
+void main()
+{
+  ivec2 texel = ivec2(Cell) >> level;
+  ivec2 page = texel >> pageShift;
+  uint slot = texelFetch(indirection, page, 0).r;
+  if (slot == 0xFFFFu)
+    discard;
+  ivec2 base = ivec2(int(slot) % atlasPages, int(slot) / atlasPages) << pageShift;
+  vec2 current = texelFetch(atlas, base + (texel & ((1 << pageShift) - 1)), 0).rg;
+
+  if (level > 0)
+  {
+    if (current.r <= 0.0)
+      discard;
+    float shade = sqrt(current.r);
+    FragColor = vec4(shade, shade, shade, 1.0);
+    return;
+  }
+
+  if (any(greaterThanEqual(fract(Cell), vec2(quadSize))))
+    discard;
+  if (current.r > 0.5)
+  {
+    FragColor = vec4(1.0);
+    return;
+  }
+  int fade = int(current.g * 255.0 + 0.5);
+  if (fade == 0)
+    discard;
+  FragColor = texelFetch(palette, ivec2(fade - 1, 0), 0);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+uniform mat4 projection;
+// screen position of the window's top left cell
+uniform vec2 origin;
+// pixels per cell
+uniform float zoom;
+// window size in cells, clipped to the grid
+uniform vec2 windowCells;
+
+out vec2 Cell;
+
+// the page window as a triangle strip; cells are relative to its corner so
+// they keep their fractions far from the grid origin
+void main()
+{
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  Cell = corner * windowCells;
+  gl_Position = projection * vec4(origin + Cell * zoom, 0, 1.0);
+}
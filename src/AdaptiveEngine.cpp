@@ -0,0 +1,95 @@
+//
+// AdaptiveEngine.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "AdaptiveEngine.hpp"
+#include "Log.hpp"
+
+namespace ge
+{
+
+void AdaptiveEngine::reset(Regime regime)
+{
+  m_regime = regime;
+  m_windows = 0;
+  m_generations = 0;
+  m_seconds = 0;
+  m_changed = 0;
+  m_populations.clear();
+  m_before = 0;
+}
+
+const char* AdaptiveEngine::name(Regime regime)
+{
+  return regime == Regime::Dense ? "dense" : "sparse";
+}
+
+bool AdaptiveEngine::repeating() const
+{
+  const int passes = static_cast<int>(m_populations.size());
+  for (int p = 1; p <= MaxPeriod && p * 2 <= passes; ++p)
+  {
+    bool repeats = true;
+    for (int i = p; i < passes && repeats; ++i)
+    {
+      repeats = m_populations[i] == m_populations[i - p];
+    }
+    if (repeats)
+      return true;
+  }
+  return false;
+}
+
+AdaptiveEngine::Regime AdaptiveEngine::record(const Sample& sample,
+    uint64_t generation)
+{
+  m_generations += sample.generations;
+  m_seconds += sample.seconds;
+  m_changed += sample.changedFraction * sample.generations;
+  m_populations.push_back(sample.population);
+  if (m_generations < Window)
+    return m_regime;
+
+  const double perGeneration = m_seconds / m_generations;
+  const double changed = m_changed / m_generations;
+  const bool repeats = repeating();
+  if (m_before > 0)
+  {
+    Printf("Adaptive: %s regime took %.3f ms per generation, was %.3f ms "
+        "(x%.2f)", name(m_regime), perGeneration * 1e3, m_before * 1e3,
+        m_before / perGeneration);
+    m_before = 0;
+  }
+
+  Regime next = m_regime;
+  if (++m_windows >= MinWindows)
+  {
+    if (m_regime == Regime::Sparse && changed > DenseAbove && !repeats)
+      next = Regime::Dense;
+    else if (m_regime == Regime::Dense && (changed < SparseBelow || repeats))
+      next = Regime::Sparse;
+  }
+  if (next != m_regime)
+  {
+    Printf("Adaptive: %s to %s at generation %llu: population %llu, "
+        "%.0f%% of tiles changing%s, %.3f ms per generation",
+        name(m_regime), name(next), static_cast<unsigned long long>(generation),
+        static_cast<unsigned long long>(sample.population), changed * 100,
+        repeats ? ", repeating" : "", perGeneration * 1e3);
+    m_regime = next;
+    m_windows = 0;
+    m_before = perGeneration;
+  }
+
+  m_generations = 0;
+  m_seconds = 0;
+  m_changed = 0;
+  m_populations.clear();
+  return m_regime;
+}
+
+} // namespace ge
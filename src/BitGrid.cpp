@@ -0,0 +1,258 @@
+//
+// BitGrid.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "BitGrid.hpp"
+#include "WorkerPool.hpp"
+
+#include <bit>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace ge
+{
+
+static uint64_t splitMix64(uint64_t& state)
+{
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+bool BitGrid::init(const ivec2& gridSize, std::unique_ptr<BitStorage> storage)
+{
+  m_gridSize = gridSize;
+  m_words = (static_cast<size_t>(gridSize.w) + 63) / 64;
+  const int lastBits = gridSize.w - static_cast<int>((m_words - 1) * 64);
+  m_lastMask = lastBits == 64 ? ~0ull : (1ull << lastBits) - 1;
+  m_storage = storage ? std::move(storage)
+    : std::make_unique<MemoryBitStorage>();
+  return m_storage->allocate(m_words * gridSize.h);
+}
+
+template <typename Rows>
+void BitGrid::forEachBand(int64_t begin, int64_t end, Rows&& rows) const
+{
+  WorkerPool& pool = WorkerPool::shared();
+  const int64_t h = end - begin;
+  const int workers = pool.size();
+  pool.runEach([&](int worker) {
+    rows(begin + h * worker / workers, begin + h * (worker + 1) / workers);
+  });
+}
+
+int64_t BitGrid::stripeRows() const
+{
+  const size_t bytes = m_storage->stripeBytes();
+  if (bytes == 0)
+    return m_gridSize.h;
+  return std::max<int64_t>(bytes / (m_words * sizeof(uint64_t)), 1);
+}
+
+void BitGrid::fillRandom(uint64_t seed, int percentage)
+{
+  // a bit is set with probability p / 256: from the lowest bit of p up,
+  // each random word is ored in for a one and anded in for a zero
+  const int p = (percentage * 256 + 50) / 100;
+  const int64_t h = m_gridSize.h;
+  const int64_t stripe = stripeRows();
+  uint64_t* words = m_storage->current();
+  for (int64_t y0 = 0; y0 < h; y0 += stripe)
+  {
+    const int64_t y1 = std::min(y0 + stripe, h);
+    forEachBand(y0, y1, [&](int64_t begin, int64_t end) {
+      for (int64_t y = begin; y < end; ++y)
+      {
+        uint64_t state = seed ^ (static_cast<uint64_t>(y) * 0xD1B54A32D192ED03ull);
+        uint64_t* row = words + y * m_words;
+        for (size_t k = 0; k < m_words; ++k)
+        {
+          uint64_t bits = 0;
+          for (int bit = 0; bit < 8; ++bit)
+          {
+            const uint64_t r = splitMix64(state);
+            bits = (p >> bit) & 1 ? r | bits : r & bits;
+          }
+          row[k] = bits;
+        }
+        row[m_words - 1] &= m_lastMask;
+      }
+    });
+    m_storage->written(words, y0 * m_words, y1 * m_words);
+  }
+}
+
+void BitGrid::load(const uint8_t* rows)
+{
+  const size_t w = m_gridSize.w;
+  uint64_t* words = m_storage->current();
+  forEachBand(0, m_gridSize.h, [&](int64_t begin, int64_t end) {
+    for (int64_t y = begin; y < end; ++y)
+    {
+      const uint8_t* cells = rows + y * w;
+      uint64_t* row = words + y * m_words;
+      for (size_t k = 0; k < m_words; ++k)
+      {
+        row[k] = 0;
+      }
+      for (size_t x = 0; x < w; ++x)
+      {
+        row[x / 64] |= static_cast<uint64_t>(cells[x] != 0) << (x % 64);
+      }
+    }
+  });
+}
+
+void BitGrid::store(uint8_t* rows) const
+{
+  const size_t w = m_gridSize.w;
+  const uint64_t* words = m_storage->current();
+  forEachBand(0, m_gridSize.h, [&](int64_t begin, int64_t end) {
+    for (int64_t y = begin; y < end; ++y)
+    {
+      const uint64_t* row = words + y * m_words;
+      uint8_t* cells = rows + y * w;
+      for (size_t x = 0; x < w; ++x)
+      {
+        cells[x] = (row[x / 64] >> (x % 64)) & 1;
+      }
+    }
+  });
+}
+
+void BitGrid::step()
+{
+  const int64_t h = m_gridSize.h;
+  const int64_t stripe = stripeRows();
+  const uint64_t* current = m_storage->current();
+  uint64_t* next = m_storage->next();
+  GridStats stats;
+  std::mutex merge;
+  for (int64_t y0 = 0; y0 < h; y0 += stripe)
+  {
+    const int64_t y1 = std::min(y0 + stripe, h);
+    // the next stripe comes in while this one is computed
+    if (y1 < h)
+      m_storage->willRead(y1 * m_words, std::min(y1 + stripe + 1, h) * m_words);
+    forEachBand(y0, y1, [&](int64_t begin, int64_t end) {
+      GridStats band;
+      for (int64_t y = begin; y < end; ++y)
+      {
+        const uint64_t* mid = current + y * m_words;
+        const uint64_t* up = current + ((y + h - 1) % h) * m_words;
+        const uint64_t* down = current + ((y + 1) % h) * m_words;
+        advanceRow(up, mid, down, next + y * m_words, y, band);
+      }
+      std::lock_guard<std::mutex> lock(merge);
+      stats.merge(band);
+    });
+    // the last row of the stripe is still the next stripe's upper neighbour
+    m_storage->doneReading(std::max<int64_t>(y0 - 1, 0) * m_words,
+        (y1 - 1) * m_words);
+    m_storage->written(next, y0 * m_words, y1 * m_words);
+  }
+  m_storage->swap();
+  m_stats = stats;
+}
+
+void BitGrid::advanceRow(const uint64_t* up, const uint64_t* mid,
+    const uint64_t* down, uint64_t* out, int64_t y, GridStats& stats) const
+{
+  const size_t last = m_words - 1;
+  // the last cell of a row, then the first, at the positions they take
+  // as neighbours across the torus seam
+  const int lastBit = std::countr_one(m_lastMask) - 1;
+  auto west = [&](const uint64_t* row, size_t k) {
+    const uint64_t carry = k > 0 ? row[k - 1] >> 63
+      : (row[last] >> lastBit) & 1;
+    return row[k] << 1 | carry;
+  };
+  auto east = [&](const uint64_t* row, size_t k) {
+    const uint64_t carry = k < last ? row[k + 1] << 63
+      : (row[0] & 1) << lastBit;
+    return row[k] >> 1 | carry;
+  };
+
+  uint64_t population = 0;
+  uint64_t births = 0;
+  uint64_t deaths = 0;
+  size_t first = m_words;
+  size_t lastLive = 0;
+  for (size_t k = 0; k < m_words; ++k)
+  {
+    // bit-sliced neighbour count: ones, twos and fours of every cell
+    const uint64_t uw = west(up, k), un = up[k], ue = east(up, k);
+    const uint64_t mw = west(mid, k), me = east(mid, k);
+    const uint64_t dw = west(down, k), dn = down[k], de = east(down, k);
+
+    const uint64_t u0 = uw ^ un ^ ue;
+    const uint64_t u1 = (uw & un) | (ue & (uw ^ un));
+    const uint64_t m0 = mw ^ me;
+    const uint64_t m1 = mw & me;
+    const uint64_t d0 = dw ^ dn ^ de;
+    const uint64_t d1 = (dw & dn) | (de & (dw ^ dn));
+
+    const uint64_t ones = u0 ^ m0 ^ d0;
+    const uint64_t carry = (u0 & m0) | (d0 & (u0 ^ m0));
+    const uint64_t t0 = u1 ^ m1 ^ d1;
+    const uint64_t t1 = (u1 & m1) | (d1 & (u1 ^ m1));
+    const uint64_t twos = t0 ^ carry;
+    // eight neighbours wrap the count to zero, which is dead as it should
+    const uint64_t fours = t1 ^ (t0 & carry);
+
+    const uint64_t next = twos & ~fours & (ones | mid[k])
+      & (k < last ? ~0ull : m_lastMask);
+    out[k] = next;
+    population += std::popcount(next);
+    births += std::popcount(next & ~mid[k]);
+    deaths += std::popcount(mid[k] & ~next);
+    if (next)
+    {
+      first = MIN(first, k);
+      lastLive = k;
+    }
+  }
+  stats.population += population;
+  stats.births += births;
+  stats.deaths += deaths;
+  if (first < m_words)
+  {
+    stats.include(static_cast<int>(first * 64 + std::countr_zero(out[first])),
+        static_cast<int>(y),
+        static_cast<int>(lastLive * 64 + 63 - std::countl_zero(out[lastLive])),
+        static_cast<int>(y));
+  }
+}
+
+uint64_t BitGrid::population() const
+{
+  std::atomic<uint64_t> total{0};
+  const int64_t h = m_gridSize.h;
+  const int64_t stripe = stripeRows();
+  const uint64_t* words = m_storage->current();
+  for (int64_t y0 = 0; y0 < h; y0 += stripe)
+  {
+    const int64_t y1 = std::min(y0 + stripe, h);
+    if (y1 < h)
+      m_storage->willRead(y1 * m_words, std::min(y1 + stripe, h) * m_words);
+    forEachBand(y0, y1, [&](int64_t begin, int64_t end) {
+      uint64_t count = 0;
+      for (size_t i = begin * m_words; i < end * m_words; ++i)
+      {
+        count += std::popcount(words[i]);
+      }
+      total += count;
+    });
+    m_storage->doneReading(y0 * m_words, y1 * m_words);
+  }
+  return total;
+}
+
+} // namespace ge
@@ -0,0 +1,195 @@
+//
+// BitStorage.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "BitStorage.hpp"
+#include "Log.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace ge
+{
+
+bool MemoryBitStorage::allocate(size_t words)
+{
+  m_current.assign(words, 0);
+  m_next.assign(words, 0);
+  return true;
+}
+
+static constexpr char Magic[8] = { 'G', 'E', 'L', 'B', 'I', 'T', 'S', '1' };
+// one page, so both halves start page aligned
+static constexpr size_t HeaderBytes = 4096;
+
+struct MappedBitStorage::Header
+{
+  char magic[8];
+  int32_t width;
+  int32_t height;
+  uint64_t generation; // of the current half
+  int32_t current;
+};
+
+MappedBitStorage::MappedBitStorage(std::string path, int width, int height)
+    : m_path{std::move(path)}
+    , m_width{width}
+    , m_height{height}
+    , m_file{-1}
+    , m_mapping{nullptr}
+    , m_mappedBytes{0}
+    , m_halfBytes{0}
+    , m_resumed{false}
+{
+}
+
+MappedBitStorage::~MappedBitStorage()
+{
+  if (m_mapping)
+  {
+    // the header last, once the grid it describes is on disk
+    msync(m_mapping, m_mappedBytes, MS_SYNC);
+    munmap(m_mapping, m_mappedBytes);
+  }
+  if (m_file >= 0)
+    close(m_file);
+}
+
+bool MappedBitStorage::allocate(size_t words)
+{
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  m_halfBytes = (words * sizeof(uint64_t) + page - 1) / page * page;
+  m_mappedBytes = HeaderBytes + 2 * m_halfBytes;
+
+  m_file = open(m_path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (m_file < 0)
+  {
+    ErrorReturn(false, "Failed to open %s", m_path.c_str());
+  }
+  Header previous = {};
+  struct stat info;
+  if (fstat(m_file, &info) == 0 && info.st_size == (off_t)m_mappedBytes)
+  {
+    if (pread(m_file, &previous, sizeof(previous), 0) != sizeof(previous))
+      previous = {};
+  }
+  m_resumed = std::memcmp(previous.magic, Magic, sizeof(Magic)) == 0
+    && previous.width == m_width && previous.height == m_height;
+  // another grid's cells are cut off rather than rewritten; the extended
+  // file reads as dead cells without taking up the disk
+  if (!m_resumed && (ftruncate(m_file, 0) != 0
+        || ftruncate(m_file, m_mappedBytes) != 0))
+  {
+    ErrorReturn(false, "Failed to size %s", m_path.c_str());
+  }
+
+  void* mapping = mmap(nullptr, m_mappedBytes, PROT_READ | PROT_WRITE,
+      MAP_SHARED, m_file, 0);
+  if (mapping == MAP_FAILED)
+  {
+    ErrorReturn(false, "Failed to map %s", m_path.c_str());
+  }
+  m_mapping = static_cast<uint8_t*>(mapping);
+  madvise(m_mapping, m_mappedBytes, MADV_SEQUENTIAL);
+  if (!m_resumed)
+  {
+    Header* h = header();
+    std::memcpy(h->magic, Magic, sizeof(Magic));
+    h->width = m_width;
+    h->height = m_height;
+    h->generation = 0;
+    h->current = 0;
+  }
+  return true;
+}
+
+MappedBitStorage::Header* MappedBitStorage::header() const
+{
+  return reinterpret_cast<Header*>(m_mapping);
+}
+
+uint64_t* MappedBitStorage::half(int which) const
+{
+  return reinterpret_cast<uint64_t*>(m_mapping + HeaderBytes
+      + which * m_halfBytes);
+}
+
+uint64_t* MappedBitStorage::current()
+{
+  return half(header()->current);
+}
+
+uint64_t* MappedBitStorage::next()
+{
+  return half(1 - header()->current);
+}
+
+void MappedBitStorage::swap()
+{
+  header()->current = 1 - header()->current;
+  ++header()->generation;
+}
+
+uint64_t MappedBitStorage::generation() const
+{
+  return header()->generation;
+}
+
+void MappedBitStorage::pages(const uint64_t* words, size_t begin, size_t end,
+    bool partial, size_t& offset, size_t& size) const
+{
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t base = reinterpret_cast<const uint8_t*>(words) - m_mapping;
+  size_t first = base + begin * sizeof(uint64_t);
+  size_t last = base + end * sizeof(uint64_t);
+  first = partial ? first / page * page : (first + page - 1) / page * page;
+  last = partial ? (last + page - 1) / page * page : last / page * page;
+  offset = first;
+  size = last > first ? last - first : 0;
+}
+
+void MappedBitStorage::willRead(size_t begin, size_t end)
+{
+  size_t offset, size;
+  pages(current(), begin, end, true, offset, size);
+  if (size > 0)
+    madvise(m_mapping + offset, size, MADV_WILLNEED);
+}
+
+void MappedBitStorage::doneReading(size_t begin, size_t end)
+{
+  // only whole pages: a page shared with the next stripe is still read
+  size_t offset, size;
+  pages(current(), begin, end, false, offset, size);
+  if (size == 0)
+    return;
+  madvise(m_mapping + offset, size, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+  posix_fadvise(m_file, offset, size, POSIX_FADV_DONTNEED);
+#endif
+}
+
+void MappedBitStorage::written(uint64_t* words, size_t begin, size_t end)
+{
+  size_t offset, size;
+  pages(words, begin, end, false, offset, size);
+  if (size == 0)
+    return;
+#ifdef SYNC_FILE_RANGE_WRITE
+  // start writing back now, in sweep order, instead of whenever the
+  // dirty pages pile up
+  sync_file_range(m_file, offset, size, SYNC_FILE_RANGE_WRITE);
+#endif
+  // the page cache keeps dirty pages until they are written; the process
+  // only lets go of them
+  madvise(m_mapping + offset, size, MADV_DONTNEED);
+}
+
+} // namespace ge
@@ -0,0 +1,295 @@
+//
+// Capture.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "Capture.hpp"
+#include "ReadBuffer.hpp"
+#include "Render.hpp"
+#include "Log.hpp"
+
+#include <glad/glad.h>
+#include <filesystem>
+#include <cstring>
+
+namespace ge
+{
+
+Capture::Capture()
+    : m_skipRows{0}
+    , m_active{false}
+    , m_y4m{false}
+    , m_buffers{}
+    , m_fences{}
+    , m_slotFrame{}
+    , m_frame{0}
+    , m_written{0}
+    , m_dropped{0}
+    , m_allocated{0}
+    , m_stopping{false}
+{
+}
+
+Capture::~Capture()
+{
+  stop();
+}
+
+bool Capture::start(std::string_view path, ivec2 size, int fps)
+{
+  if (m_active)
+    stop();
+
+  m_size = size;
+  m_skipRows = 0;
+  m_path = path;
+  m_y4m = m_path.size() > 4 && m_path.compare(m_path.size() - 4, 4, ".y4m") == 0;
+  if (m_y4m)
+  {
+    m_video.open(m_path, std::ofstream::binary | std::ofstream::trunc);
+    if (!m_video.is_open())
+      ErrorReturn(false, "Failed to open capture file %s", m_path.c_str());
+    // 4:2:0 chroma needs even dimensions, the last row/column is cropped;
+    // GL rows start at the bottom, so the row is skipped when reading
+    m_skipRows = m_size.h & 1;
+    m_size.w &= ~1;
+    m_size.h &= ~1;
+    m_video << "YUV4MPEG2 W" << m_size.w << " H" << m_size.h << " F" << fps
+            << ":1 Ip A1:1 C420jpeg\n";
+  }
+  else
+  {
+    std::error_code error;
+    std::filesystem::create_directories(m_path, error);
+    if (error)
+      ErrorReturn(false, "Failed to create capture directory %s",
+          m_path.c_str());
+  }
+
+  const size_t bytes = static_cast<size_t>(size.w) * size.h * 4;
+  glGenBuffers(RingSize, m_buffers);
+  for (int i = 0; i < RingSize; ++i)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[i]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    m_fences[i] = nullptr;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  m_frame = m_written = m_dropped = 0;
+  m_stopping = false;
+  m_active = true;
+  m_writer = std::thread(&Capture::writerLoop, this);
+  Printf("Capturing to %s", m_path.c_str());
+  return true;
+}
+
+void Capture::stop()
+{
+  if (!m_active)
+    return;
+
+  // stopping may wait: collect what is still in flight, oldest first
+  for (uint64_t frame = m_frame >= RingSize ? m_frame - RingSize : 0;
+       frame < m_frame; ++frame)
+  {
+    int slot = frame % RingSize;
+    if (m_fences[slot])
+    {
+      glClientWaitSync(static_cast<GLsync>(m_fences[slot]),
+          GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+      collect(slot);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_ready.notify_one();
+  m_writer.join();
+
+  glDeleteBuffers(RingSize, m_buffers);
+  m_video.close();
+  m_queue.clear();
+  m_free.clear();
+  m_allocated = 0;
+  m_active = false;
+  Printf("Capture stopped: %llu frames written, %llu dropped",
+      static_cast<unsigned long long>(m_written),
+      static_cast<unsigned long long>(m_dropped));
+}
+
+bool Capture::active() const
+{
+  return m_active;
+}
+
+void Capture::readFrame()
+{
+  if (!m_active)
+    return;
+
+  // the oldest slot is about to be reused, take its frame if it is ready
+  const int slot = m_frame % RingSize;
+  if (m_fences[slot])
+  {
+    GLenum status = glClientWaitSync(static_cast<GLsync>(m_fences[slot]), 0, 0);
+    if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+    {
+      collect(slot);
+    }
+    else
+    {
+      glDeleteSync(static_cast<GLsync>(m_fences[slot]));
+      m_fences[slot] = nullptr;
+      ++m_dropped;
+    }
+  }
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, Render::targetFramebuffer());
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[slot]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, m_skipRows, m_size.w, m_size.h, GL_RGBA, GL_UNSIGNED_BYTE,
+      nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  m_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  m_slotFrame[slot] = m_frame++;
+}
+
+void Capture::collect(int slot)
+{
+  glDeleteSync(static_cast<GLsync>(m_fences[slot]));
+  m_fences[slot] = nullptr;
+
+  std::unique_ptr<Frame> frame;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_free.empty())
+    {
+      frame = std::move(m_free.back());
+      m_free.pop_back();
+    }
+    else if (m_allocated < QueueLimit)
+    {
+      frame = std::make_unique<Frame>();
+      ++m_allocated;
+    }
+  }
+  if (!frame)
+  {
+    // the writer is behind by QueueLimit frames
+    ++m_dropped;
+    return;
+  }
+
+  const size_t bytes = static_cast<size_t>(m_size.w) * m_size.h * 4;
+  frame->pixels.resize(bytes);
+  frame->index = m_slotFrame[slot];
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[slot]);
+  void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes,
+      GL_MAP_READ_BIT);
+  if (data)
+  {
+    std::memcpy(frame->pixels.data(), data, bytes);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (data)
+      m_queue.push_back(std::move(frame));
+    else
+      m_free.push_back(std::move(frame));
+  }
+  m_ready.notify_one();
+}
+
+void Capture::writerLoop()
+{
+  for (;;)
+  {
+    std::unique_ptr<Frame> frame;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_ready.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+      if (m_queue.empty())
+        return;
+      frame = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+
+    if (m_y4m)
+      writeY4M(*frame);
+    else
+      writePPM(*frame);
+    ++m_written;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(std::move(frame));
+  }
+}
+
+void Capture::writeY4M(const Frame& frame)
+{
+  // BT.601 full range, chroma averaged over 2x2 pixels
+  const int w = m_size.w, h = m_size.h;
+  const size_t stride = static_cast<size_t>(w) * 4;
+  m_scratch.resize(static_cast<size_t>(w) * h * 3 / 2);
+  uint8_t* yPlane = m_scratch.data();
+  uint8_t* uPlane = yPlane + w * h;
+  uint8_t* vPlane = uPlane + (w / 2) * (h / 2);
+  for (int y = 0; y < h; ++y)
+  {
+    // GL rows start at the bottom
+    const uint8_t* row = frame.pixels.data() + (h - 1 - y) * stride;
+    for (int x = 0; x < w; ++x)
+    {
+      const uint8_t* p = row + x * 4;
+      yPlane[y * w + x] = static_cast<uint8_t>(
+          (77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+    }
+  }
+  for (int y = 0; y < h / 2; ++y)
+  {
+    const uint8_t* row0 = frame.pixels.data() + (h - 1 - 2 * y) * stride;
+    const uint8_t* row1 = row0 - stride;
+    for (int x = 0; x < w / 2; ++x)
+    {
+      int r = row0[x * 8] + row0[x * 8 + 4] + row1[x * 8] + row1[x * 8 + 4];
+      int g = row0[x * 8 + 1] + row0[x * 8 + 5] + row1[x * 8 + 1]
+        + row1[x * 8 + 5];
+      int b = row0[x * 8 + 2] + row0[x * 8 + 6] + row1[x * 8 + 2]
+        + row1[x * 8 + 6];
+      uPlane[y * (w / 2) + x] = static_cast<uint8_t>(CLAMP(
+          (-43 * r - 85 * g + 128 * b + 512) / 1024 + 128, 0, 255));
+      vPlane[y * (w / 2) + x] = static_cast<uint8_t>(CLAMP(
+          (128 * r - 107 * g - 21 * b + 512) / 1024 + 128, 0, 255));
+    }
+  }
+  m_video << "FRAME\n";
+  m_video.write(reinterpret_cast<const char*>(m_scratch.data()),
+      m_scratch.size());
+}
+
+void Capture::writePPM(const Frame& frame)
+{
+  const size_t stride = static_cast<size_t>(m_size.w) * 4;
+  m_scratch.resize(frame.pixels.size());
+  for (int y = 0; y < m_size.h; ++y)
+  {
+    std::memcpy(m_scratch.data() + y * stride,
+        frame.pixels.data() + (m_size.h - 1 - y) * stride, stride);
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "frame_%06llu.ppm",
+      static_cast<unsigned long long>(frame.index));
+  File::writePPM((std::filesystem::path(m_path) / name).string(), m_size.w,
+      m_size.h, m_scratch);
+}
+
+} // namespace ge
@@ -0,0 +1,458 @@
+//
+// Census.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "Census.hpp"
+#include "WorkerPool.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace ge
+{
+
+namespace
+{
+
+// one phase of an object run alone, cropped to its live cells; origin is
+// where the box has moved to since the first phase
+struct Phase
+{
+  int w;
+  int h;
+  std::vector<uint8_t> cells;
+  ivec2 origin;
+};
+
+} // namespace
+
+// advances a phase one generation on an unbounded plane, false once it
+// has died out
+static bool advance(Phase& phase)
+{
+  const int w = phase.w + 2;
+  const int h = phase.h + 2;
+  auto alive = [&](int x, int y) {
+    return x >= 0 && y >= 0 && x < phase.w && y < phase.h
+      && phase.cells[y * phase.w + x];
+  };
+  std::vector<uint8_t> next(static_cast<size_t>(w) * h);
+  ivec2 min = { w, h };
+  ivec2 max = { -1, -1 };
+  for (int y = 0; y < h; ++y)
+  {
+    for (int x = 0; x < w; ++x)
+    {
+      // cell (x, y) of the grown box is (x - 1, y - 1) of the phase
+      int neighbours = 0;
+      for (int dy = -2; dy <= 0; ++dy)
+      {
+        for (int dx = -2; dx <= 0; ++dx)
+        {
+          neighbours += alive(x + dx, y + dy);
+        }
+      }
+      const bool self = alive(x - 1, y - 1);
+      neighbours -= self;
+      if (neighbours == 3 || (self && neighbours == 2))
+      {
+        next[y * w + x] = 1;
+        min = { MIN(min.x, x), MIN(min.y, y) };
+        max = { MAX(max.x, x), MAX(max.y, y) };
+      }
+    }
+  }
+  if (max.x < 0)
+    return false;
+
+  phase.w = max.x - min.x + 1;
+  phase.h = max.y - min.y + 1;
+  phase.cells.assign(static_cast<size_t>(phase.w) * phase.h, 0);
+  for (int y = 0; y < phase.h; ++y)
+  {
+    std::copy_n(next.begin() + (min.y + y) * w + min.x, phase.w,
+        phase.cells.begin() + y * phase.w);
+  }
+  phase.origin = { phase.origin.x + min.x - 1, phase.origin.y + min.y - 1 };
+  return true;
+}
+
+// extended Wechsler format of a phase under one of the 8 symmetries: bit
+// 0 mirrors x, bit 1 mirrors y and bit 2 swaps the axes. Strips of 5 rows
+// are written a column at a time, one digit of 32 per column, and
+// separated by z; runs of 0 become w, x or y and a count, and trailing
+// ones are dropped.
+static std::string wechsler(const Phase& phase, int symmetry)
+{
+  static constexpr char Digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  const bool swap = symmetry & 4;
+  const int w = swap ? phase.h : phase.w;
+  const int h = swap ? phase.w : phase.h;
+  auto alive = [&](int x, int y) {
+    int sx = swap ? y : x;
+    int sy = swap ? x : y;
+    sx = symmetry & 1 ? phase.w - 1 - sx : sx;
+    sy = symmetry & 2 ? phase.h - 1 - sy : sy;
+    return phase.cells[sy * phase.w + sx] != 0;
+  };
+
+  std::string code;
+  for (int y0 = 0; y0 < h; y0 += 5)
+  {
+    if (y0 > 0)
+      code += 'z';
+    int zeros = 0;
+    for (int x = 0; x < w; ++x)
+    {
+      int column = 0;
+      for (int k = 0; k < 5 && y0 + k < h; ++k)
+      {
+        column |= alive(x, y0 + k) << k;
+      }
+      if (column == 0)
+      {
+        ++zeros;
+        continue;
+      }
+      for (; zeros >= 4; zeros -= 4 + MIN(zeros - 4, 35))
+      {
+        code += 'y';
+        code += Digits[MIN(zeros - 4, 35)];
+      }
+      code += zeros == 3 ? "x" : zeros == 2 ? "w" : zeros == 1 ? "0" : "";
+      zeros = 0;
+      code += Digits[column];
+    }
+  }
+  return code;
+}
+
+// the shortest, then the smallest, code of any phase in any orientation
+static std::string canonical(const std::vector<Phase>& phases)
+{
+  std::string best;
+  for (const Phase& phase : phases)
+  {
+    for (int symmetry = 0; symmetry < 8; ++symmetry)
+    {
+      std::string code = wechsler(phase, symmetry);
+      if (best.empty() || code.size() < best.size()
+          || (code.size() == best.size() && code < best))
+        best = std::move(code);
+    }
+  }
+  return best;
+}
+
+std::string Census::classify(const std::vector<uint8_t>& cells, int w, int h)
+{
+  std::vector<Phase> phases = { { w, h, cells, { 0, 0 } } };
+  Phase phase = phases.front();
+  for (int period = 1; period <= MaxPeriod; ++period)
+  {
+    if (!advance(phase) || phase.w > MaxSide || phase.h > MaxSide)
+      break;
+    if (phase.w == w && phase.h == h && phase.cells == cells)
+    {
+      const bool moved = phase.origin.x != 0 || phase.origin.y != 0;
+      std::string prefix;
+      if (moved)
+        prefix = "xq" + std::to_string(period);
+      else if (period > 1)
+        prefix = "xp" + std::to_string(period);
+      else
+        prefix = "xs" + std::to_string(std::count(cells.begin(), cells.end(), 1));
+      return prefix + "_" + canonical(phases);
+    }
+    phases.push_back(phase);
+  }
+  phases.resize(1);
+  return "zz_" + canonical(phases);
+}
+
+// moves coordinates on a torus of `size` so the object starts at 0, with
+// the largest gap between its cells across the seam; returns its extent
+static int unwrap(std::vector<int>& coords, int size)
+{
+  std::vector<int> sorted = coords;
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  int start = sorted.front();
+  int gap = sorted.front() + size - sorted.back();
+  for (size_t k = 1; k < sorted.size(); ++k)
+  {
+    if (sorted[k] - sorted[k - 1] > gap)
+    {
+      gap = sorted[k] - sorted[k - 1];
+      start = sorted[k];
+    }
+  }
+  for (int& c : coords)
+  {
+    c = (c - start + size) % size;
+  }
+  return size - gap + 1;
+}
+
+uint32_t Census::label(const std::vector<uint8_t>& cells, const ivec2& gridSize)
+{
+  WorkerPool& pool = WorkerPool::shared();
+  const int w = gridSize.w;
+  const int h = gridSize.h;
+  const int workers = pool.size();
+  m_parent.resize(static_cast<size_t>(w) * h);
+  m_root.resize(m_parent.size());
+  auto index = [w](int x, int y) {
+    return static_cast<size_t>(y) * w + x;
+  };
+  auto live = [&](int x, int y) {
+    return cells[index(x, y)] != 0;
+  };
+  // path halving; the root of a component is its first cell
+  auto find = [&](uint32_t i) {
+    while (m_parent[i] != i)
+    {
+      m_parent[i] = m_parent[m_parent[i]];
+      i = m_parent[i];
+    }
+    return i;
+  };
+  auto unite = [&](uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a < b)
+      m_parent[b] = a;
+    else if (b < a)
+      m_parent[a] = b;
+  };
+  auto band = [&](int worker, int& begin, int& end) {
+    begin = static_cast<int>(static_cast<int64_t>(h) * worker / workers);
+    end = static_cast<int>(static_cast<int64_t>(h) * (worker + 1) / workers);
+  };
+
+  // every band joins its own cells with their west and upper neighbours
+  pool.runEach([&](int worker) {
+    int begin, end;
+    band(worker, begin, end);
+    for (int y = begin; y < end; ++y)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        if (!live(x, y))
+          continue;
+        const uint32_t i = static_cast<uint32_t>(index(x, y));
+        m_parent[i] = i;
+        if (x > 0 && live(x - 1, y))
+          unite(i, i - 1);
+        for (int dx = -1; dx <= 1 && y > begin; ++dx)
+        {
+          if (x + dx >= 0 && x + dx < w && live(x + dx, y - 1))
+            unite(i, i - w + dx);
+        }
+      }
+    }
+  });
+
+  // the seams: the first row of every band with the row above it, and
+  // the last column with the first, around the torus
+  auto join = [&](int x0, int y0, int x1, int y1) {
+    x1 = (x1 + w) % w;
+    y1 = (y1 + h) % h;
+    if (live(x0, y0) && live(x1, y1))
+      unite(static_cast<uint32_t>(index(x0, y0)),
+          static_cast<uint32_t>(index(x1, y1)));
+  };
+  for (int worker = 0; worker < workers; ++worker)
+  {
+    int begin, end;
+    band(worker, begin, end);
+    for (int x = 0; x < w && begin < end; ++x)
+    {
+      for (int dx = -1; dx <= 1; ++dx)
+      {
+        join(x, begin, x + dx, begin - 1);
+      }
+    }
+  }
+  for (int y = 0; y < h; ++y)
+  {
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+      join(w - 1, y, 0, y + dy);
+    }
+  }
+
+  // roots, then one number per component in the order of their first
+  // cells, then the cells of each band with their component
+  std::vector<uint32_t> roots(workers);
+  pool.runEach([&](int worker) {
+    int begin, end;
+    band(worker, begin, end);
+    for (size_t i = index(0, begin); i < index(0, end); ++i)
+    {
+      if (!cells[i])
+        continue;
+      uint32_t root = static_cast<uint32_t>(i);
+      while (m_parent[root] != root)
+      {
+        root = m_parent[root];
+      }
+      m_root[i] = root;
+      roots[worker] += root == i;
+    }
+  });
+  std::vector<uint32_t> firsts(workers + 1);
+  for (int worker = 0; worker < workers; ++worker)
+  {
+    firsts[worker + 1] = firsts[worker] + roots[worker];
+  }
+  std::vector<std::vector<Cell>> bands(workers);
+  pool.runEach([&](int worker) {
+    int begin, end;
+    band(worker, begin, end);
+    uint32_t next = firsts[worker];
+    for (size_t i = index(0, begin); i < index(0, end); ++i)
+    {
+      if (cells[i] && m_root[i] == i)
+        m_parent[i] = next++;
+    }
+  });
+  pool.runEach([&](int worker) {
+    int begin, end;
+    band(worker, begin, end);
+    for (size_t i = index(0, begin); i < index(0, end); ++i)
+    {
+      if (cells[i])
+      {
+        bands[worker].push_back({ m_parent[m_root[i]],
+            static_cast<int>(i % w), static_cast<int>(i / w) });
+      }
+    }
+  });
+
+  // sorted by component, each in scan order
+  const uint32_t count = firsts[workers];
+  std::vector<uint32_t> offsets(count + 1);
+  size_t total = 0;
+  for (const std::vector<Cell>& cellsOfBand : bands)
+  {
+    for (const Cell& cell : cellsOfBand)
+    {
+      ++offsets[cell.component + 1];
+    }
+    total += cellsOfBand.size();
+  }
+  for (uint32_t c = 0; c < count; ++c)
+  {
+    offsets[c + 1] += offsets[c];
+  }
+  m_cells.resize(total);
+  for (const std::vector<Cell>& cellsOfBand : bands)
+  {
+    for (const Cell& cell : cellsOfBand)
+    {
+      m_cells[offsets[cell.component]++] = cell;
+    }
+  }
+  return count;
+}
+
+void Census::add(const std::vector<uint8_t>& cells, const ivec2& gridSize)
+{
+  // the labels are cell indices, 32 bits each
+  if (static_cast<uint64_t>(gridSize.w) * gridSize.h > UINT32_MAX)
+  {
+    Error("A %dx%d grid is too large for a census", gridSize.w, gridSize.h);
+    return;
+  }
+  WorkerPool& pool = WorkerPool::shared();
+  if (m_known.size() > MaxKnown)
+    m_known.clear();
+  const uint32_t count = label(cells, gridSize);
+  std::vector<uint32_t> firsts(count + 1);
+  for (size_t k = 0; k < m_cells.size(); ++k)
+  {
+    firsts[m_cells[k].component + 1] = static_cast<uint32_t>(k + 1);
+  }
+
+  // the box of every component as a key: its size, then its cells;
+  // empty for one too large to run alone
+  std::vector<std::string> keys(count);
+  pool.run(static_cast<int>(count), [&](int c) {
+    std::vector<int> xs, ys;
+    for (uint32_t k = firsts[c]; k < firsts[c + 1]; ++k)
+    {
+      xs.push_back(m_cells[k].x);
+      ys.push_back(m_cells[k].y);
+    }
+    const int w = unwrap(xs, gridSize.w);
+    const int h = unwrap(ys, gridSize.h);
+    if (w > MaxSide || h > MaxSide)
+      return;
+    std::string& key = keys[c];
+    key.assign(2 + static_cast<size_t>(w) * h, 0);
+    key[0] = static_cast<char>(w);
+    key[1] = static_cast<char>(h);
+    for (size_t k = 0; k < xs.size(); ++k)
+    {
+      key[2 + ys[k] * w + xs[k]] = 1;
+    }
+  });
+
+  // objects not seen before are classified in parallel, each once
+  std::vector<std::string> unknown;
+  std::unordered_set<std::string> pending;
+  for (const std::string& key : keys)
+  {
+    if (!key.empty() && !m_known.count(key) && pending.insert(key).second)
+      unknown.push_back(key);
+  }
+  std::vector<std::string> codes(unknown.size());
+  pool.run(static_cast<int>(unknown.size()), [&](int u) {
+    const std::string& key = unknown[u];
+    const std::vector<uint8_t> box(key.begin() + 2, key.end());
+    codes[u] = classify(box, key[0], key[1]);
+  });
+
+  for (size_t u = 0; u < unknown.size(); ++u)
+  {
+    m_known.emplace(std::move(unknown[u]), codes[u]);
+  }
+  for (uint32_t c = 0; c < count; ++c)
+  {
+    ++m_counts[keys[c].empty() ? "zz_LARGE" : m_known.find(keys[c])->second];
+  }
+  m_objects += count;
+}
+
+void Census::clear()
+{
+  m_counts.clear();
+  m_objects = 0;
+}
+
+void Census::log(size_t top) const
+{
+  std::vector<std::pair<uint64_t, std::string>> sorted;
+  for (const auto& [code, count] : m_counts)
+  {
+    sorted.emplace_back(count, code);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  });
+  Printf("%llu objects of %zu kinds", static_cast<unsigned long long>(m_objects),
+      sorted.size());
+  for (size_t i = 0; i < MIN(top, sorted.size()); ++i)
+  {
+    Printf("%10llu %s", static_cast<unsigned long long>(sorted[i].first),
+        sorted[i].second.c_str());
+  }
+}
+
+} // namespace ge
@@ -0,0 +1,137 @@
+//
+// CpuTopology.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "CpuTopology.hpp"
+#include "Utility.hpp"
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <cctype>
+
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+namespace ge
+{
+
+namespace CpuTopology
+{
+
+// the topology lists a nodeN entry under every CPU of a NUMA system
+static int nodeOf(int cpu)
+{
+  std::error_code error;
+  std::filesystem::directory_iterator it(
+      "/sys/devices/system/cpu/cpu" + std::to_string(cpu), error);
+  for (; !error && it != std::filesystem::directory_iterator(); ++it)
+  {
+    const std::string name = it->path().filename().string();
+    if (name.size() > 4 && name.compare(0, 4, "node") == 0
+        && std::isdigit(static_cast<unsigned char>(name[4])))
+      return std::stoi(name.substr(4));
+  }
+  return 0;
+}
+
+std::vector<int> usableCpus()
+{
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    return cpus;
+  std::vector<std::pair<int, int>> byNode;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (CPU_ISSET(cpu, &set))
+      byNode.emplace_back(nodeOf(cpu), cpu);
+  }
+  std::sort(byNode.begin(), byNode.end());
+  for (const auto& entry : byNode)
+  {
+    cpus.push_back(entry.second);
+  }
+#endif
+  return cpus;
+}
+
+int quotaCpus()
+{
+  int cpus = 0;
+  auto limit = [&cpus](long long quota, long long period) {
+    if (quota <= 0 || period <= 0)
+      return;
+    const int allowed = static_cast<int>((quota + period - 1) / period);
+    cpus = cpus == 0 ? allowed : MIN(cpus, allowed);
+  };
+
+  // cgroup v2: "<quota> <period>" or "max <period>" in the cpu.max of the
+  // process's group and of every group above it
+  std::ifstream groups("/proc/self/cgroup");
+  std::string line;
+  while (std::getline(groups, line))
+  {
+    if (line.compare(0, 3, "0::") != 0)
+      continue;
+    std::string group = line.substr(3);
+    for (;;)
+    {
+      std::ifstream max("/sys/fs/cgroup" + (group == "/" ? "" : group)
+          + "/cpu.max");
+      long long quota = 0, period = 0;
+      if (max >> quota >> period)
+        limit(quota, period);
+      if (group.size() <= 1)
+        break;
+      group = group.substr(0, group.rfind('/'));
+    }
+  }
+
+  // cgroup v1, as mounted inside a container
+  for (const std::string dir : { "/sys/fs/cgroup/cpu",
+      "/sys/fs/cgroup/cpu,cpuacct" })
+  {
+    long long quota = 0, period = 0;
+    std::ifstream(dir + "/cpu.cfs_quota_us") >> quota;
+    std::ifstream(dir + "/cpu.cfs_period_us") >> period;
+    limit(quota, period);
+  }
+  return cpus;
+}
+
+int workerCount()
+{
+  int count = static_cast<int>(usableCpus().size());
+  if (count == 0)
+    count = static_cast<int>(std::thread::hardware_concurrency());
+  if (const int quota = quotaCpus(); quota > 0)
+    count = MIN(count, quota);
+  return MAX(count, 1);
+}
+
+bool pinThread(int cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+} // namespace CpuTopology
+
+} // namespace ge
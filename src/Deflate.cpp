@@ -0,0 +1,251 @@
+//
+// Deflate.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "Deflate.hpp"
+
+#include <array>
+
+namespace ge
+{
+
+namespace
+{
+
+constexpr int WindowSize = 1 << 15;
+constexpr int HashBits = 15;
+constexpr int MinMatch = 3;
+constexpr int MaxMatch = 258;
+constexpr int MaxChain = 32;
+
+constexpr uint16_t LengthBase[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+constexpr uint8_t LengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+constexpr uint16_t DistanceBase[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+  8193, 12289, 16385, 24577
+};
+constexpr uint8_t DistanceExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+class BitWriter
+{
+public:
+  explicit BitWriter(std::vector<uint8_t>& out) : m_out{out}, m_bits{0}, m_count{0} { }
+
+  void put(uint32_t value, int count)
+  {
+    m_bits |= static_cast<uint64_t>(value) << m_count;
+    m_count += count;
+    while (m_count >= 8)
+    {
+      m_out.push_back(static_cast<uint8_t>(m_bits));
+      m_bits >>= 8;
+      m_count -= 8;
+    }
+  }
+
+  // Huffman codes are defined most significant bit first
+  void putCode(uint32_t code, int count)
+  {
+    uint32_t reversed = 0;
+    for (int i = 0; i < count; ++i)
+    {
+      reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    put(reversed, count);
+  }
+
+  void align()
+  {
+    if (m_count > 0)
+      put(0, 8 - m_count);
+  }
+
+private:
+  std::vector<uint8_t>& m_out;
+  uint64_t m_bits;
+  int m_count;
+};
+
+void putLiteral(BitWriter& bits, int symbol)
+{
+  if (symbol < 144)
+    bits.putCode(0x30 + symbol, 8);
+  else if (symbol < 256)
+    bits.putCode(0x190 + symbol - 144, 9);
+  else if (symbol < 280)
+    bits.putCode(symbol - 256, 7);
+  else
+    bits.putCode(0xC0 + symbol - 280, 8);
+}
+
+void putMatch(BitWriter& bits, int length, int distance)
+{
+  int l = 28;
+  while (LengthBase[l] > length) --l;
+  putLiteral(bits, 257 + l);
+  bits.put(length - LengthBase[l], LengthExtra[l]);
+
+  int d = 29;
+  while (DistanceBase[d] > distance) --d;
+  bits.putCode(d, 5);
+  bits.put(distance - DistanceBase[d], DistanceExtra[d]);
+}
+
+inline uint32_t hash3(const uint8_t* p)
+{
+  uint32_t v = p[0] | p[1] << 8 | p[2] << 16;
+  return (v * 2654435761u) >> (32 - HashBits);
+}
+
+} // namespace
+
+void Deflate::compress(const uint8_t* data, size_t size, bool last,
+    std::vector<uint8_t>& out)
+{
+  BitWriter bits(out);
+  // one fixed Huffman block for the whole run
+  bits.put(last ? 1 : 0, 1);
+  bits.put(1, 2);
+
+  std::vector<int64_t> head(1 << HashBits, -1);
+  std::vector<int64_t> prev(WindowSize, -1);
+  auto insert = [&](size_t pos) {
+    uint32_t h = hash3(data + pos);
+    prev[pos & (WindowSize - 1)] = head[h];
+    head[h] = static_cast<int64_t>(pos);
+  };
+
+  size_t pos = 0;
+  while (pos < size)
+  {
+    int bestLength = 0;
+    size_t bestDistance = 0;
+    if (pos + MinMatch <= size)
+    {
+      const size_t limit = size - pos < MaxMatch ? size - pos : MaxMatch;
+      int64_t candidate = head[hash3(data + pos)];
+      for (int chain = 0; candidate >= 0 && chain < MaxChain; ++chain)
+      {
+        const size_t distance = pos - candidate;
+        if (distance > WindowSize - 1)
+          break;
+        const uint8_t* a = data + candidate;
+        const uint8_t* b = data + pos;
+        size_t length = 0;
+        while (length < limit && a[length] == b[length]) ++length;
+        if (static_cast<int>(length) > bestLength)
+        {
+          bestLength = static_cast<int>(length);
+          bestDistance = distance;
+          if (length == limit)
+            break;
+        }
+        candidate = prev[candidate & (WindowSize - 1)];
+      }
+    }
+
+    if (bestLength >= MinMatch)
+    {
+      putMatch(bits, bestLength, static_cast<int>(bestDistance));
+      const size_t end = pos + bestLength;
+      for (; pos < end; ++pos)
+      {
+        if (pos + MinMatch <= size)
+          insert(pos);
+      }
+    }
+    else
+    {
+      putLiteral(bits, data[pos]);
+      if (pos + MinMatch <= size)
+        insert(pos);
+      ++pos;
+    }
+  }
+  putLiteral(bits, 256);
+
+  if (!last)
+  {
+    // empty stored block: byte aligns the run so the next one can follow
+    bits.put(0, 1);
+    bits.put(0, 2);
+    bits.align();
+    bits.put(0x0000, 16);
+    bits.put(0xFFFF, 16);
+  }
+  bits.align();
+}
+
+uint32_t Deflate::adler32(const uint8_t* data, size_t size, uint32_t adler)
+{
+  constexpr uint32_t Base = 65521;
+  // 5552 bytes is the longest run before the sums can overflow 32 bits
+  uint32_t a = adler & 0xFFFF, b = adler >> 16;
+  while (size > 0)
+  {
+    size_t n = size < 5552 ? size : 5552;
+    size -= n;
+    while (n--)
+    {
+      a += *data++;
+      b += a;
+    }
+    a %= Base;
+    b %= Base;
+  }
+  return a | (b << 16);
+}
+
+uint32_t Deflate::adler32Combine(uint32_t adlerA, uint32_t adlerB,
+    uint64_t sizeB)
+{
+  constexpr uint32_t Base = 65521;
+  const uint32_t rem = static_cast<uint32_t>(sizeB % Base);
+  uint32_t sum1 = adlerA & 0xFFFF;
+  uint32_t sum2 = static_cast<uint32_t>(
+      (static_cast<uint64_t>(rem) * sum1) % Base);
+  sum1 += (adlerB & 0xFFFF) + Base - 1;
+  sum2 += (adlerA >> 16) + (adlerB >> 16) + Base - rem;
+  if (sum1 >= Base) sum1 -= Base;
+  if (sum1 >= Base) sum1 -= Base;
+  if (sum2 >= (Base << 1)) sum2 -= (Base << 1);
+  if (sum2 >= Base) sum2 -= Base;
+  return sum1 | (sum2 << 16);
+}
+
+uint32_t Deflate::crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k)
+        c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[n] = c;
+    }
+    return t;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+} // namespace ge
@@ -0,0 +1,107 @@
+//
+// DensityPyramid.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "DensityPyramid.hpp"
+
+#include <algorithm>
+
+namespace ge
+{
+
+void DensityPyramid::init(const ivec2& gridSize)
+{
+  m_gridSize = gridSize;
+  m_tiles = {
+    (gridSize.w + TileSize - 1) / TileSize,
+    (gridSize.h + TileSize - 1) / TileSize,
+  };
+  m_dirty = std::vector<std::atomic<uint8_t>>(
+      static_cast<size_t>(m_tiles.w) * m_tiles.h);
+  m_pending.clear();
+  m_updated.clear();
+  m_changedCount = 0;
+
+  m_levels.clear();
+  m_sizes.clear();
+  ivec2 size = gridSize;
+  while (size.w > 1 || size.h > 1)
+  {
+    size = { (size.w + 1) / 2, (size.h + 1) / 2 };
+    m_sizes.push_back(size);
+    m_levels.emplace_back(static_cast<size_t>(size.w) * size.h, 0);
+  }
+}
+
+void DensityPyramid::markAllChanged()
+{
+  m_pending.clear();
+  for (size_t t = 0; t < m_dirty.size(); ++t)
+  {
+    m_dirty[t].store(1, std::memory_order_relaxed);
+    m_pending.push_back(static_cast<uint32_t>(t));
+  }
+}
+
+void DensityPyramid::takeChanged(std::vector<uint32_t>& marked)
+{
+  m_pending.insert(m_pending.end(), marked.begin(), marked.end());
+  marked.clear();
+}
+
+double DensityPyramid::changedFraction() const
+{
+  return static_cast<double>(m_changedCount)
+    / (static_cast<double>(m_tiles.w) * m_tiles.h);
+}
+
+void DensityPyramid::sumChildren(int level, int x, int y)
+{
+  const ivec2 size = m_sizes[level - 2];
+  const uint32_t* children = m_levels[level - 2].data();
+  const int cx = x * 2;
+  const int cy = y * 2;
+  const size_t row = static_cast<size_t>(cy) * size.w;
+  uint32_t count = children[row + cx];
+  if (cx + 1 < size.w) count += children[row + cx + 1];
+  if (cy + 1 < size.h)
+  {
+    count += children[row + size.w + cx];
+    if (cx + 1 < size.w) count += children[row + size.w + cx + 1];
+  }
+  m_levels[level - 1][static_cast<size_t>(y) * m_sizes[level - 1].w + x] =
+    count;
+}
+
+void DensityPyramid::propagate()
+{
+  // the changed tiles become the changed blocks of the tile level; each
+  // level above only recounts the parents of blocks that changed below it
+  std::vector<ivec2>& blocks = m_changedTiles;
+  for (int level = TileShift + 1; level <= levels(); ++level)
+  {
+    const int width = m_sizes[level - 1].w;
+    for (auto& block : blocks)
+    {
+      block = { block.x >> 1, block.y >> 1 };
+    }
+    auto key = [width](const ivec2& b) {
+      return static_cast<int64_t>(b.y) * width + b.x;
+    };
+    std::sort(blocks.begin(), blocks.end(),
+        [&key](const ivec2& l, const ivec2& r) { return key(l) < key(r); });
+    blocks.erase(std::unique(blocks.begin(), blocks.end(),
+        [&key](const ivec2& l, const ivec2& r) { return key(l) == key(r); }),
+        blocks.end());
+    for (const auto& block : blocks)
+    {
+      sumChildren(level, block.x, block.y);
+    }
+  }
+}
+
+} // namespace ge
@@ -0,0 +1,106 @@
+//
+// FadeTrails.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "FadeTrails.hpp"
+#include "Render.hpp"
+#include "Log.hpp"
+
+#include <glad/glad.h>
+
+namespace ge
+{
+
+void FadeTrails::init(ivec2 gridSize, int fadeGrades)
+{
+  m_gridSize = gridSize;
+  m_fadeGrades = fadeGrades;
+
+  glGenTextures(1, &m_texture);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  std::vector<uint8_t> empty(static_cast<size_t>(gridSize.w) * gridSize.h * 2);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, gridSize.w, gridSize.h, 0, GL_RG,
+      GL_UNSIGNED_BYTE, empty.data());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glGenTextures(1, &m_alive);
+  glBindTexture(GL_TEXTURE_2D, m_alive);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, gridSize.w, gridSize.h, 0, GL_RED,
+      GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+      m_texture, 0);
+  Assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE,
+      "Trail framebuffer is incomplete");
+  glBindFramebuffer(GL_FRAMEBUFFER, Render::targetFramebuffer());
+  glGenVertexArrays(1, &m_vao);
+
+  m_program.load("shaders/life.vert", "shaders/trail.frag");
+  m_program.use();
+  glUniform1i(glGetUniformLocation(m_program.getId(), "alive"), 0);
+  // a live cell's counter sits one above the palette, so the generation
+  // it dies in shows the last palette entry like the CPU fade counter
+  glUniform1f(glGetUniformLocation(m_program.getId(), "lifeGrade"),
+      (fadeGrades + 1) / 255.f);
+  m_decayLocation = glGetUniformLocation(m_program.getId(), "decay");
+}
+
+void FadeTrails::quit()
+{
+  if (m_texture == 0)
+    return;
+  m_program.quit();
+  glDeleteVertexArrays(1, &m_vao);
+  glDeleteFramebuffers(1, &m_framebuffer);
+  glDeleteTextures(1, &m_alive);
+  glDeleteTextures(1, &m_texture);
+  m_texture = 0;
+}
+
+void FadeTrails::accumulate(const uint8_t* alive, uint64_t generations)
+{
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_alive);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_gridSize.w, m_gridSize.h, GL_RED,
+      GL_UNSIGNED_BYTE, alive);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  int viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glViewport(0, 0, m_gridSize.w, m_gridSize.h);
+  m_program.use();
+  glBindVertexArray(m_vao);
+
+  // dst - src with unorm saturation: alive drops to 0, the fade counter
+  // loses one grade per generation and stops at 0
+  const uint64_t grades = MIN(generations, static_cast<uint64_t>(255));
+  glBlendEquation(GL_FUNC_REVERSE_SUBTRACT);
+  glBlendFunc(GL_ONE, GL_ONE);
+  glUniform1f(m_decayLocation, grades / 255.f);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+
+  glDisable(GL_BLEND);
+  glUniform1f(m_decayLocation, 0);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+
+  glEnable(GL_BLEND);
+  glBlendEquation(GL_FUNC_ADD);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glBindFramebuffer(GL_FRAMEBUFFER, Render::targetFramebuffer());
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+} // namespace ge
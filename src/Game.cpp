@@ -11,18 +11,46 @@
 #include "Render.hpp"
 #include "Vector.hpp"
 #include "Simulator.hpp"
+#include "GpuSimulator.hpp"
 #include "PauseState.hpp"
+#include "ReadBuffer.hpp"
+#include "Deflate.hpp"
+#include "BitGrid.hpp"
+#include "Census.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <map>
+#include <memory>
+#include <random>
 #include <thread>
 #include <ctime>
 
 namespace ge
 {
 
-static KeyState keyState[2];
+static KeyState keyState[static_cast<int>(Key::Count)] = {
+  { GLFW_KEY_SPACE },
+  { GLFW_KEY_R },
+  { GLFW_KEY_LEFT },
+  { GLFW_KEY_RIGHT },
+  { GLFW_KEY_UP },
+  { GLFW_KEY_DOWN },
+  { GLFW_KEY_EQUAL },
+  { GLFW_KEY_MINUS },
+  { GLFW_KEY_HOME },
+  { GLFW_KEY_C },
+  { GLFW_KEY_P },
+  { GLFW_KEY_V },
+  { GLFW_KEY_T },
+  { GLFW_KEY_H },
+  { GLFW_KEY_BACKSPACE },
+  { GLFW_KEY_E },
+  { GLFW_KEY_A },
+};
 GameContext Game::Context;
 static vec2T<double> mousePos;
+static double scrollOffset;
 
 void keyCallBack(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
@@ -41,11 +69,18 @@ void keyCallBack(GLFWwindow* window, int key, int scancode, int action, int mods
   }
 }
 
+void scrollCallBack(GLFWwindow*, double, double yoffset)
+{
+  scrollOffset += yoffset;
+}
+
 Game::Game(std::string_view title, int width, int height, int tile_w, int tile_h)
 : m_window(nullptr)
 , m_size(width, height)
 , m_tileSize(tile_w, tile_h)
 , m_title(title)
+, m_simulator(StateId::Simulator)
+, m_drawnGeneration(UINT64_MAX)
 {
   Context.StateStack = &m_stack;
 }
@@ -53,11 +88,12 @@ Game::Game(std::string_view title, int width, int height, int tile_w, int tile_h
 void Game::init()
 {
   m_stack.registerState<Simulator>(StateId::Simulator);
+  m_stack.registerState<GpuSimulator>(StateId::GpuSimulator);
   m_stack.registerState<PauseState>(StateId::PauseState);
-  m_stack.requestStateChange(StateChange::Push, StateId::Simulator);
+  m_stack.requestStateChange(StateChange::Push, m_simulator);
 }
 
-int Game::run()
+ivec2 Game::configure()
 {
   int side;
   std::cout << "side: ";
@@ -65,14 +101,48 @@ int Game::run()
   m_tileSize.w = m_tileSize.h = side;
   Context.Side = side;
 
+  ivec2 gridSize;
+  std::cout << "grid size (0 0 to fit the screen): ";
+  std::cin >> gridSize.w >> gridSize.h;
+
+  int engine;
+  std::cout << "engine (0 cpu, 1 gpu): ";
+  std::cin >> engine;
+  m_simulator = engine == 1 ? StateId::GpuSimulator : StateId::Simulator;
+  return gridSize;
+}
+
+void Game::setupView(ivec2 gridSize)
+{
+  if (gridSize.w <= 0 || gridSize.h <= 0)
+  {
+    gridSize = {
+      Context.View.viewport.w / Context.Side,
+      Context.View.viewport.h / Context.Side,
+    };
+  }
+  Context.GridSize = gridSize;
+  Context.View.zoom = static_cast<float>(Context.Side);
+  Context.View.position = vec2();
+}
+
+int Game::run()
+{
+  ivec2 gridSize = configure();
+
   bool rc = Render::Init(&m_window, m_title, m_size, m_tileSize);
   Assert(m_window != nullptr, "SHOT");
   glfwGetFramebufferSize(m_window, &m_size.w, &m_size.h);
   glfwSetKeyCallback(m_window, keyCallBack);
+  glfwSetScrollCallback(m_window, scrollCallBack);
   Assert(rc, "Unable to initialize game. Quitting.");
+
+  setupView(gridSize);
   init();
 
   glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+  // keep short taps visible to glfwGetKey while blocked in glfwWaitEvents
+  glfwSetInputMode(m_window, GLFW_STICKY_KEYS, GLFW_TRUE);
 
   double lastTime, thisTime, accumulator = 0;
   float delta = 1.f / 120.f;
@@ -108,22 +178,494 @@ int Game::run()
   return 0;
 }
 
+int Game::runOffscreen(int frames, std::string_view snapshot,
+    std::string_view capture, bool software)
+{
+  ivec2 gridSize = configure();
+  std::cout << "seed (0 for random): ";
+  std::cin >> Context.Seed;
+
+  if (software)
+  {
+    // the GPU engine and the capture pipeline both need a GL context
+    m_simulator = StateId::Simulator;
+    Render::InitSoftware(m_size);
+  }
+  else
+  {
+    Assert(Render::InitOffscreen(m_size),
+        "Unable to initialize offscreen rendering. Quitting.");
+    if (!capture.empty() && m_capture.start(capture, m_size, 120))
+      Render::setCapture(&m_capture);
+  }
+  // the GPU engine is checked against the banded CPU engine, started from
+  // the same soup, so both need the seed up front
+  const bool checkGpu = m_simulator == StateId::GpuSimulator;
+  if (checkGpu && Context.Seed == 0)
+    Context.Seed = std::random_device()();
+  setupView(gridSize);
+  init();
+
+  GameContext cpuContext;
+  std::unique_ptr<Simulator> cpu;
+  std::vector<uint8_t> state, cells;
+  int rc = 0;
+
+  // every frame goes through the full draw path, the render cache is
+  // bypassed so the timings cover list building, upload and draw
+  using Clock = std::chrono::steady_clock;
+  const float delta = 1.f / 120.f;
+  double updateTime = 0, drawTime = 0, endTime = 0;
+  for (int i = 0; i < frames && rc == 0; ++i)
+  {
+    uint64_t generation = Context.Generation;
+    auto t0 = Clock::now();
+    m_stack.update(delta);
+    auto t1 = Clock::now();
+    Render::begin();
+    m_stack.draw();
+    auto t2 = Clock::now();
+    Render::end();
+    auto t3 = Clock::now();
+    updateTime += std::chrono::duration<double>(t1 - t0).count();
+    drawTime += std::chrono::duration<double>(t2 - t1).count();
+    endTime += std::chrono::duration<double>(t3 - t2).count();
+
+    GpuSimulator* gpu = checkGpu ? m_stack.getState<GpuSimulator>() : nullptr;
+    const bool started = gpu && !cpu;
+    if (started)
+    {
+      // the states are built at the end of the first update, so the CPU
+      // engine starts on the soup the GPU one was just filled with
+      cpuContext = Context;
+      cpu = std::make_unique<Simulator>(cpuContext);
+      cpu->setEngine(Simulator::Engine::Banded);
+      generation = Context.Generation;
+    }
+    if (started || (gpu && Context.Generation != generation))
+    {
+      for (uint64_t g = generation; g < Context.Generation; ++g)
+      {
+        cpu->step();
+      }
+      gpu->readState(state);
+      cpu->snapshot(cells);
+      for (size_t c = 0; c < cells.size(); ++c)
+      {
+        if ((state[c * 2] != 0) != (cells[c] != 0))
+        {
+          Error("Generation %llu: the GPU and CPU engines differ at (%d, %d)",
+              static_cast<unsigned long long>(Context.Generation),
+              static_cast<int>(c % Context.GridSize.w),
+              static_cast<int>(c / Context.GridSize.w));
+          rc = 1;
+          break;
+        }
+      }
+    }
+  }
+
+  if (frames > 0)
+  {
+    Printf("%d offscreen frames at %dx%d, average ms: update %.3f, "
+        "draw %.3f, flush %.3f", frames, m_size.w, m_size.h,
+        updateTime * 1000 / frames, drawTime * 1000 / frames,
+        endTime * 1000 / frames);
+  }
+
+  m_capture.stop();
+  if (!snapshot.empty())
+  {
+    std::vector<uint8_t> pixels;
+    Render::readPixels(pixels);
+    if (!File::writePPM(snapshot, m_size.w, m_size.h, pixels))
+      return 1;
+  }
+  return rc;
+}
+
+int Game::runPoster(uint64_t generations, int scale,
+    std::string_view filename)
+{
+  ivec2 gridSize = configure();
+  std::cout << "seed (0 for random): ";
+  std::cin >> Context.Seed;
+
+  m_simulator = StateId::Simulator;
+  Render::InitSoftware(m_size);
+  setupView(gridSize);
+  init();
+
+  const float delta = 1.f / 120.f;
+  do
+  {
+    m_stack.update(delta);
+  } while (Context.Generation < generations);
+
+  Simulator* simulator = m_stack.getState<Simulator>();
+  return simulator && simulator->exportPoster(filename, MAX(scale, 1)) ? 0 : 1;
+}
+
+// mean and 99th percentile of the step times in seconds
+static void logTicks(std::vector<double>& ticks)
+{
+  if (ticks.empty())
+    return;
+  std::sort(ticks.begin(), ticks.end());
+  double total = 0;
+  for (double tick : ticks)
+  {
+    total += tick;
+  }
+  Printf("step: mean %.3f ms, p99 %.3f ms", total * 1e3 / ticks.size(),
+      ticks[(ticks.size() - 1) * 99 / 100] * 1e3);
+}
+
+// the counts the last pass gathered
+static void logStats(const GridStats& stats)
+{
+  if (stats.empty())
+  {
+    Printf("population 0, %llu deaths in the last pass",
+        static_cast<unsigned long long>(stats.deaths));
+    return;
+  }
+  Printf("population %llu, %llu births and %llu deaths in the last pass, "
+      "live cells in (%d, %d)-(%d, %d)",
+      static_cast<unsigned long long>(stats.population),
+      static_cast<unsigned long long>(stats.births),
+      static_cast<unsigned long long>(stats.deaths),
+      stats.min.x, stats.min.y, stats.max.x, stats.max.y);
+}
+
+int Game::runBenchmark(ivec2 gridSize, uint64_t generations)
+{
+  Render::InitSoftware(m_size);
+  Context.GridSize = gridSize;
+  Context.Side = 1;
+  Context.Seed = Context.Seed ? Context.Seed : 1;
+  // whole passes of the deepest engine so every engine ends on the same
+  // generation
+  const uint64_t depth = Simulator::TemporalDepth;
+  generations = (generations + depth - 1) / depth * depth;
+
+  using Clock = std::chrono::steady_clock;
+  const Simulator::Engine engines[] = {
+    Simulator::Engine::Banded,
+    Simulator::Engine::TemporalBlocked,
+    Simulator::Engine::InPlace,
+    Simulator::Engine::Adaptive,
+  };
+  const double cellGenerations =
+    static_cast<double>(gridSize.w) * gridSize.h * generations;
+  uint32_t reference = 0;
+  int rc = 0;
+  std::vector<uint8_t> cells;
+  std::vector<double> ticks;
+  for (size_t e = 0; e < std::size(engines); ++e)
+  {
+    Context.Generation = 0;
+    Simulator simulator(Context);
+    simulator.setEngine(engines[e]);
+    ticks.clear();
+    auto start = Clock::now();
+    while (Context.Generation < generations)
+    {
+      const auto tick = Clock::now();
+      simulator.step();
+      ticks.push_back(std::chrono::duration<double>(Clock::now() - tick)
+          .count());
+    }
+    const double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    simulator.snapshot(cells);
+    const uint32_t crc = Deflate::crc32(cells.data(), cells.size());
+    if (e == 0)
+      reference = crc;
+    else if (crc != reference)
+      rc = 1;
+    Printf("%dx%d, %llu generations: %.3f s, %.3f ns per cell generation, "
+        "crc %08x%s", gridSize.w, gridSize.h,
+        static_cast<unsigned long long>(generations), seconds,
+        seconds * 1e9 / cellGenerations, crc,
+        crc == reference ? "" : " MISMATCH");
+    logTicks(ticks);
+    logStats(simulator.stats());
+  }
+
+  // the same soup cut down to one corner of an empty grid: most tiles are
+  // still and the activity sits in the bands of a few workers
+  Context.Generation = 0;
+  {
+    Simulator simulator(Context);
+    simulator.snapshot(cells);
+    for (int y = 0; y < gridSize.h; ++y)
+    {
+      for (int x = 0; x < gridSize.w; ++x)
+      {
+        if (x >= gridSize.w / 4 || y >= gridSize.h / 4)
+          cells[static_cast<size_t>(y) * gridSize.w + x] = 0;
+      }
+    }
+    simulator.load(cells);
+    Context.Generation = 0;
+    Printf("Engine: banded, soup in one corner");
+    ticks.clear();
+    auto start = Clock::now();
+    while (Context.Generation < generations)
+    {
+      const auto tick = Clock::now();
+      simulator.step();
+      ticks.push_back(std::chrono::duration<double>(Clock::now() - tick)
+          .count());
+    }
+    const double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    Printf("%dx%d, %llu generations: %.3f s, %.3f ns per cell generation",
+        gridSize.w, gridSize.h, static_cast<unsigned long long>(generations),
+        seconds, seconds * 1e9 / cellGenerations);
+    logTicks(ticks);
+    logStats(simulator.stats());
+  }
+
+  // the bit-packed grid starts from the same soup
+  Context.Generation = 0;
+  {
+    Simulator simulator(Context);
+    simulator.snapshot(cells);
+  }
+  BitGrid bits;
+  bits.init(gridSize);
+  bits.load(cells.data());
+  Printf("Engine: bit-packed, headless");
+  auto start = Clock::now();
+  for (uint64_t g = 0; g < generations; ++g)
+  {
+    bits.step();
+  }
+  const double seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+  bits.store(cells.data());
+  const uint32_t crc = Deflate::crc32(cells.data(), cells.size());
+  if (crc != reference)
+    rc = 1;
+  Printf("%dx%d, %llu generations: %.3f s, %.3f ns per cell generation, "
+      "crc %08x%s", gridSize.w, gridSize.h,
+      static_cast<unsigned long long>(generations), seconds,
+      seconds * 1e9 / cellGenerations, crc,
+      crc == reference ? "" : " MISMATCH");
+  logStats(bits.stats());
+  return rc;
+}
+
+int Game::runSoak(ivec2 gridSize, uint64_t soups, uint64_t generations)
+{
+  Render::InitSoftware(m_size);
+  Context.GridSize = gridSize;
+  Context.Side = 1;
+  using Clock = std::chrono::steady_clock;
+  uint64_t stabilized = 0;
+  uint64_t stableSum = 0;
+  uint64_t computed = 0;
+  std::map<uint64_t, uint64_t> periods;
+  Census census;
+  std::vector<uint8_t> cells;
+  double censusSeconds = 0;
+  auto start = Clock::now();
+  for (uint64_t soup = 1; soup <= soups; ++soup)
+  {
+    Context.Seed = static_cast<uint32_t>(soup);
+    Context.Generation = 0;
+    Simulator simulator(Context);
+    simulator.setOnCycle(Simulator::OnCycle::FastForward, generations);
+    while (Context.Generation < generations)
+    {
+      simulator.step();
+      ++computed;
+    }
+    if (simulator.cyclePeriod() > 0)
+    {
+      ++stabilized;
+      stableSum += simulator.stableSince();
+      ++periods[simulator.cyclePeriod()];
+      // what the soup settled into
+      const auto taken = Clock::now();
+      simulator.snapshot(cells);
+      census.add(cells, gridSize);
+      censusSeconds +=
+        std::chrono::duration<double>(Clock::now() - taken).count();
+    }
+  }
+  const double seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+  Printf("%llu soups of %dx%d in %.3f s, %.2f soups per second",
+      static_cast<unsigned long long>(soups), gridSize.w, gridSize.h, seconds,
+      soups / seconds);
+  Printf("%llu stabilized, on average at generation %.0f; %llu generations "
+      "computed, %llu skipped", static_cast<unsigned long long>(stabilized),
+      stabilized ? static_cast<double>(stableSum) / stabilized : 0.0,
+      static_cast<unsigned long long>(computed),
+      static_cast<unsigned long long>(soups * generations - computed));
+  for (const auto& [period, count] : periods)
+  {
+    Printf("period %llu: %llu soups", static_cast<unsigned long long>(period),
+        static_cast<unsigned long long>(count));
+  }
+  Printf("census of the stabilized soups: %.3f ms per soup",
+      stabilized ? censusSeconds * 1e3 / stabilized : 0.0);
+  census.log(20);
+  return 0;
+}
+
+int Game::runHeadless(ivec2 gridSize, uint64_t generations, uint64_t seed,
+    std::string_view filename)
+{
+  using Clock = std::chrono::steady_clock;
+  BitGrid grid;
+  MappedBitStorage* mapped = nullptr;
+  std::unique_ptr<BitStorage> storage;
+  if (!filename.empty())
+  {
+    auto file = std::make_unique<MappedBitStorage>(std::string(filename),
+        gridSize.w, gridSize.h);
+    mapped = file.get();
+    storage = std::move(file);
+  }
+  auto start = Clock::now();
+  if (!grid.init(gridSize, std::move(storage)))
+    return 1;
+  const bool resumed = mapped && mapped->resumed();
+  if (resumed)
+  {
+    Printf("%s: resuming at generation %llu", std::string(filename).c_str(),
+        static_cast<unsigned long long>(mapped->generation()));
+  }
+  else
+  {
+    grid.fillRandom(seed, Simulator::InitCellsCountPercentage);
+  }
+  Printf("%dx%d, %.3g cells in %.2f GiB: %s in %.3f s, population %llu",
+      gridSize.w, gridSize.h, static_cast<double>(grid.cellCount()),
+      2.0 * grid.cellCount() / 8 / (1 << 30), resumed ? "loaded" : "seeded",
+      std::chrono::duration<double>(Clock::now() - start).count(),
+      static_cast<unsigned long long>(grid.population()));
+
+  start = Clock::now();
+  for (uint64_t g = 0; g < generations; ++g)
+  {
+    grid.step();
+  }
+  const double seconds =
+    std::chrono::duration<double>(Clock::now() - start).count();
+  Printf("%llu generations: %.3f s, %.3f ns per cell generation",
+      static_cast<unsigned long long>(generations), seconds,
+      seconds * 1e9 / (static_cast<double>(grid.cellCount())
+        * MAX(generations, uint64_t(1))));
+  if (generations > 0)
+    logStats(grid.stats());
+  if (mapped)
+  {
+    Printf("%s: saved at generation %llu", std::string(filename).c_str(),
+        static_cast<unsigned long long>(mapped->generation()));
+  }
+  return 0;
+}
+
 void Game::update(const float delta)
 {
-  keyState[0].previous = keyState[0].current;
-  keyState[1].previous = keyState[1].current;
-  keyState[0].current = glfwGetKey(m_window, GLFW_KEY_SPACE);
-  keyState[1].current = glfwGetKey(m_window, GLFW_KEY_R);
+  for (auto& key : keyState)
+  {
+    key.previous = key.current;
+    key.current = glfwGetKey(m_window, key.keyCode);
+  }
+  if (isKeyJustPressed(Key::Capture))
+  {
+    toggleCapture();
+  }
   m_stack.update(delta);
-  Render::begin();
-  m_stack.draw();
-  Render::end();
+  if (updateCamera(delta))
+  {
+    m_drawnGeneration = UINT64_MAX;
+  }
+  if (Context.Generation != m_drawnGeneration)
+  {
+    Render::begin();
+    m_stack.draw();
+    Render::end();
+    m_drawnGeneration = Context.Generation;
+  }
+  else
+  {
+    Render::present();
+  }
   glfwGetCursorPos(m_window, &mousePos.x, &mousePos.y);
-  glfwPollEvents();
+  if (Context.Paused)
+    glfwWaitEvents();
+  else
+    glfwPollEvents();
+}
+
+bool Game::updateCamera(const float delta)
+{
+  Camera& view = Context.View;
+  bool changed = false;
+
+  if (isKeyJustPressed(Key::ResetView))
+  {
+    view.fit(Context.GridSize);
+    changed = true;
+  }
+
+  vec2 pan;
+  if (isKeyDown(Key::PanLeft))  pan.x -= 1;
+  if (isKeyDown(Key::PanRight)) pan.x += 1;
+  if (isKeyDown(Key::PanUp))    pan.y -= 1;
+  if (isKeyDown(Key::PanDown))  pan.y += 1;
+  if (pan.x != 0 || pan.y != 0)
+  {
+    view.position += pan * (PanSpeed * delta / view.zoom);
+    changed = true;
+  }
+
+  if (scrollOffset != 0)
+  {
+    view.zoomAt(getMousePosition(), std::pow(ZoomStep, scrollOffset));
+    scrollOffset = 0;
+    changed = true;
+  }
+
+  float zoom = 0;
+  if (isKeyDown(Key::ZoomIn))  zoom += 1;
+  if (isKeyDown(Key::ZoomOut)) zoom -= 1;
+  if (zoom != 0)
+  {
+    vec2 centre(view.viewport.w * 0.5f, view.viewport.h * 0.5f);
+    view.zoomAt(centre, std::pow(ZoomRate, zoom * delta));
+    changed = true;
+  }
+
+  return changed;
+}
+
+void Game::toggleCapture()
+{
+  if (m_capture.active())
+  {
+    m_capture.stop();
+    Render::setCapture(nullptr);
+    return;
+  }
+  char name[32];
+  std::time_t t = std::time(nullptr);
+  std::strftime(name, sizeof(name), "capture-%Y%m%d-%H%M%S.y4m",
+      std::localtime(&t));
+  if (m_capture.start(name, Render::getSize(), 120))
+    Render::setCapture(&m_capture);
 }
 
 Game::~Game()
 {
+  m_capture.stop();
   Render::Quit();
 }
 
@@ -133,6 +675,11 @@ bool Game::isKeyJustPressed(Key code)
      && !keyState[static_cast<int>(code)].previous;
 }
 
+bool Game::isKeyDown(Key code)
+{
+  return keyState[static_cast<int>(code)].current;
+}
+
 vec2 Game::getMousePosition()
 {
   return vec2(mousePos);
@@ -0,0 +1,169 @@
+//
+// GpuSimulator.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "GpuSimulator.hpp"
+#include "Simulator.hpp"
+#include "Render.hpp"
+#include "Game.hpp"
+#include "Log.hpp"
+
+#include <glad/glad.h>
+#include <random>
+
+namespace ge
+{
+
+GpuSimulator::GpuSimulator(GameContext& context)
+    : State{context}
+    , m_gridSize{context.GridSize}
+    , m_resetRequested{false}
+    , m_accum{0}
+    , m_current{0}
+{
+  int maxSize;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  Assert(m_gridSize.w <= maxSize && m_gridSize.h <= maxSize,
+      "Grid %dx%d exceeds GL_MAX_TEXTURE_SIZE %d", m_gridSize.w,
+      m_gridSize.h, maxSize);
+
+  glGenTextures(2, m_textures);
+  glGenFramebuffers(2, m_framebuffers);
+  for (int i = 0; i < 2; ++i)
+  {
+    glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, m_gridSize.w, m_gridSize.h, 0,
+        GL_RG, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[i]);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D, m_textures[i], 0);
+    Assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE,
+        "State framebuffer %d is incomplete", i);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, Render::targetFramebuffer());
+  glGenVertexArrays(1, &m_vao);
+
+  std::vector<vec4> palette = Simulator::fadePalette();
+  m_program.load("shaders/life.vert", "shaders/life.frag");
+  m_program.use();
+  glUniform1i(glGetUniformLocation(m_program.getId(), "state"), 0);
+  glUniform1i(glGetUniformLocation(m_program.getId(), "fadeGrades"),
+      static_cast<int>(palette.size()));
+  Render::setGridPalette(palette);
+
+  fillWithRandom();
+}
+
+GpuSimulator::~GpuSimulator()
+{
+  m_program.quit();
+  glDeleteVertexArrays(1, &m_vao);
+  glDeleteFramebuffers(2, m_framebuffers);
+  glDeleteTextures(2, m_textures);
+}
+
+void GpuSimulator::fillWithRandom()
+{
+  std::random_device rd;
+  std::mt19937 gen(m_context.Seed ? m_context.Seed : rd());
+  const int64_t cells = static_cast<int64_t>(m_gridSize.w) * m_gridSize.h;
+  int64_t initialCellsCount =
+    cells * Simulator::InitCellsCountPercentage / 100;
+  std::uniform_int_distribution<int64_t> rndIndex(0, cells - 1);
+  std::vector<uint8_t> state(cells * 2, 0);
+  for (int64_t i = 0; i < initialCellsCount; ++i)
+  {
+    int64_t candidate = rndIndex(gen);
+    if (state[candidate * 2] == 0)
+    {
+      state[candidate * 2] = 255;
+    }
+    else
+      --i;
+  }
+  writeState(state);
+}
+
+void GpuSimulator::writeState(const std::vector<uint8_t>& state)
+{
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glBindTexture(GL_TEXTURE_2D, m_textures[m_current]);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_gridSize.w, m_gridSize.h, GL_RG,
+      GL_UNSIGNED_BYTE, state.data());
+  ++m_context.Generation;
+}
+
+void GpuSimulator::readState(std::vector<uint8_t>& state) const
+{
+  state.resize(static_cast<size_t>(m_gridSize.w) * m_gridSize.h * 2);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[m_current]);
+  glReadPixels(0, 0, m_gridSize.w, m_gridSize.h, GL_RG, GL_UNSIGNED_BYTE,
+      state.data());
+  glBindFramebuffer(GL_FRAMEBUFFER, Render::targetFramebuffer());
+}
+
+bool GpuSimulator::update(const float)
+{
+  if (Game::isKeyJustPressed(Key::Pause))
+  {
+    m_context.StateStack->requestStateChange(StateChange::Push, StateId::PauseState);
+  }
+  if (Game::isKeyJustPressed(Key::Restart))
+  {
+    m_resetRequested = true;
+  }
+
+  if (++m_accum < Simulator::UpdateEvery)
+  {
+    return false;
+  }
+  m_accum = 0;
+
+  if (m_resetRequested)
+  {
+    m_resetRequested = false;
+    fillWithRandom();
+    return false;
+  }
+  step();
+  return false;
+}
+
+void GpuSimulator::step()
+{
+  int viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  glDisable(GL_BLEND);
+
+  const int next = 1 - m_current;
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[next]);
+  glViewport(0, 0, m_gridSize.w, m_gridSize.h);
+  m_program.use();
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_textures[m_current]);
+  glBindVertexArray(m_vao);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  m_current = next;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, Render::targetFramebuffer());
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  glEnable(GL_BLEND);
+  ++m_context.Generation;
+}
+
+void GpuSimulator::draw()
+{
+  Render::drawGrid(m_textures[m_current], m_gridSize);
+}
+
+} // namespace ge
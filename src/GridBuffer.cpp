@@ -0,0 +1,92 @@
+//
+// GridBuffer.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "GridBuffer.hpp"
+#include "WorkerPool.hpp"
+#include "Utility.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <new>
+
+namespace ge
+{
+
+namespace GridMemory
+{
+
+static size_t roundUp(size_t size, size_t to)
+{
+  return (size + to - 1) / to * to;
+}
+
+void* map(size_t bytes, size_t& mapped)
+{
+  const int protection = PROT_READ | PROT_WRITE;
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  bytes = bytes ? bytes : 1;
+  if (bytes < HugePageSize)
+  {
+    // pages are aligned far past Alignment
+    mapped = roundUp(bytes, page);
+    void* memory = mmap(nullptr, mapped, protection, flags, -1, 0);
+    if (memory == MAP_FAILED)
+      throw std::bad_alloc();
+    return memory;
+  }
+
+  mapped = roundUp(bytes, HugePageSize);
+#ifdef MAP_HUGETLB
+  // explicit huge pages, only there when the system has them reserved
+  void* huge = mmap(nullptr, mapped, protection, flags | MAP_HUGETLB, -1, 0);
+  if (huge != MAP_FAILED)
+    return huge;
+#endif
+
+  // transparent huge pages only back aligned 2 MiB ranges, so map one
+  // page more than needed and trim both ends to a boundary
+  uint8_t* memory = static_cast<uint8_t*>(mmap(nullptr,
+        mapped + HugePageSize, protection, flags, -1, 0));
+  if (memory == MAP_FAILED)
+    throw std::bad_alloc();
+  const size_t head = roundUp(reinterpret_cast<uintptr_t>(memory),
+      HugePageSize) - reinterpret_cast<uintptr_t>(memory);
+  if (head > 0)
+    munmap(memory, head);
+  munmap(memory + head + mapped, HugePageSize - head);
+  memory += head;
+#ifdef MADV_HUGEPAGE
+  madvise(memory, mapped, MADV_HUGEPAGE);
+#endif
+  return memory;
+}
+
+void unmap(void* memory, size_t mapped)
+{
+  munmap(memory, mapped);
+}
+
+void fillChunks(size_t bytes, const std::function<void(size_t, size_t)>& fill)
+{
+  WorkerPool& pool = WorkerPool::shared();
+  const size_t chunks = (bytes + HugePageSize - 1) / HugePageSize;
+  const size_t workers = pool.size();
+  pool.runEach([&](int worker) {
+    for (size_t chunk = chunks * worker / workers;
+        chunk < chunks * (worker + 1) / workers; ++chunk)
+    {
+      const size_t begin = chunk * HugePageSize;
+      fill(begin, MIN(begin + HugePageSize, bytes));
+    }
+  });
+}
+
+} // namespace GridMemory
+
+} // namespace ge
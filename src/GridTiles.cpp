@@ -0,0 +1,67 @@
+//
+// GridTiles.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "GridTiles.hpp"
+
+#include <algorithm>
+
+namespace ge
+{
+
+// moves the bits of v to the even bit positions
+static uint64_t spreadBits(uint32_t v)
+{
+  uint64_t x = v;
+  x = (x | x << 16) & 0x0000FFFF0000FFFFull;
+  x = (x | x << 8) & 0x00FF00FF00FF00FFull;
+  x = (x | x << 4) & 0x0F0F0F0F0F0F0F0Full;
+  x = (x | x << 2) & 0x3333333333333333ull;
+  x = (x | x << 1) & 0x5555555555555555ull;
+  return x;
+}
+
+static uint64_t morton(int tx, int ty)
+{
+  return spreadBits(tx) | spreadBits(ty) << 1;
+}
+
+void GridTiles::init(const ivec2& gridSize)
+{
+  m_gridSize = gridSize;
+  m_columns = (gridSize.w + TileSize - 1) >> TileShift;
+  const int rows = (gridSize.h + TileSize - 1) >> TileShift;
+
+  m_tiles.clear();
+  m_tiles.reserve(static_cast<size_t>(m_columns) * rows);
+  for (int ty = 0; ty < rows; ++ty)
+  {
+    for (int tx = 0; tx < m_columns; ++tx)
+    {
+      const ivec2 origin(tx << TileShift, ty << TileShift);
+      m_tiles.push_back({ origin, { MIN(TileSize, gridSize.w - origin.x),
+          MIN(TileSize, gridSize.h - origin.y) }, 0 });
+    }
+  }
+  // grids that are not square powers of two leave gaps in the curve,
+  // the order still holds
+  std::sort(m_tiles.begin(), m_tiles.end(), [](const Tile& l, const Tile& r) {
+    return morton(l.origin.x >> TileShift, l.origin.y >> TileShift)
+      < morton(r.origin.x >> TileShift, r.origin.y >> TileShift);
+  });
+
+  m_base.resize(m_tiles.size());
+  for (size_t i = 0; i < m_tiles.size(); ++i)
+  {
+    Tile& tile = m_tiles[i];
+    tile.base = i * TileCells;
+    m_base[(tile.origin.y >> TileShift) * m_columns
+      + (tile.origin.x >> TileShift)] = tile.base;
+  }
+}
+
+} // namespace ge
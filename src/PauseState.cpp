@@ -9,19 +9,31 @@
 #include "PauseState.hpp"
 #include "GameContext.hpp"
 #include "Game.hpp"
+#include "Simulator.hpp"
 
 namespace ge
 {
 
 PauseState::PauseState(GameContext& context) : State(context)
 {
+  m_context.Paused = true;
+}
 
+PauseState::~PauseState()
+{
+  m_context.Paused = false;
 }
 
 bool PauseState::update(const float)
 {
   if (Game::isKeyJustPressed(Key::Pause))
     m_context.StateStack->requestStateChange(StateChange::Pop);
+  // stepping back is most useful with the simulation stopped
+  if (Game::isKeyJustPressed(Key::Rewind))
+  {
+    if (Simulator* simulator = m_context.StateStack->getState<Simulator>())
+      simulator->rewind(1);
+  }
   return false;
 }
 
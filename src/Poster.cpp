@@ -0,0 +1,183 @@
+//
+// Poster.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "Poster.hpp"
+#include "Deflate.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "WorkerPool.hpp"
+#include "Log.hpp"
+
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+
+namespace ge
+{
+
+// target size of one strip's filtered scanlines
+static constexpr size_t StripBytes = 1 << 20;
+
+static void putU32(std::vector<uint8_t>& out, uint32_t v)
+{
+  out.push_back(static_cast<uint8_t>(v >> 24));
+  out.push_back(static_cast<uint8_t>(v >> 16));
+  out.push_back(static_cast<uint8_t>(v >> 8));
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+// `chunk` holds 4 placeholder length bytes followed by type and data
+static void sealChunk(std::vector<uint8_t>& chunk)
+{
+  const uint32_t length = static_cast<uint32_t>(chunk.size() - 8);
+  for (int i = 0; i < 4; ++i)
+    chunk[i] = static_cast<uint8_t>(length >> (24 - 8 * i));
+  putU32(chunk, Deflate::crc32(chunk.data() + 4, chunk.size() - 4));
+}
+
+static void beginChunk(std::vector<uint8_t>& chunk, const char* type)
+{
+  chunk.assign(4, 0);
+  chunk.insert(chunk.end(), type, type + 4);
+}
+
+namespace
+{
+
+struct Strip
+{
+  SoftwareRasterizer raster;
+  std::vector<vec2> translations;
+  std::vector<vec4> colors;
+  std::vector<uint8_t> scanlines;
+  std::vector<uint8_t> chunk;
+  uint32_t adler;
+};
+
+} // namespace
+
+bool Poster::writePNG(std::string_view filename, ivec2 gridSize, int scale,
+    float quadSize, const StripSource& source)
+{
+  const uint64_t width = static_cast<uint64_t>(gridSize.w) * scale;
+  const uint64_t height = static_cast<uint64_t>(gridSize.h) * scale;
+  if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX)
+  {
+    ErrorReturn(false, "Poster size %llux%llu is out of range",
+        static_cast<unsigned long long>(width),
+        static_cast<unsigned long long>(height));
+  }
+  std::ofstream file(std::string(filename), std::ofstream::binary);
+  if (!file.is_open())
+  {
+    ErrorReturn(false, "Failed to open file %s", filename.data());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const size_t rowBytes = 1 + width * 3;
+  const int stripCells = static_cast<int>(
+      MAX(static_cast<size_t>(1), StripBytes / (rowBytes * scale)));
+  const int strips = (gridSize.h + stripCells - 1) / stripCells;
+
+  std::vector<uint8_t> header = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+  };
+  std::vector<uint8_t> chunk;
+  beginChunk(chunk, "IHDR");
+  putU32(chunk, static_cast<uint32_t>(width));
+  putU32(chunk, static_cast<uint32_t>(height));
+  // 8 bit RGB, deflate, adaptive filtering, no interlace
+  chunk.insert(chunk.end(), { 8, 2, 0, 0, 0 });
+  sealChunk(chunk);
+  header.insert(header.end(), chunk.begin(), chunk.end());
+  // the zlib header goes alone, each strip then adds one IDAT of its own
+  beginChunk(chunk, "IDAT");
+  chunk.insert(chunk.end(), { 0x78, 0x01 });
+  sealChunk(chunk);
+  header.insert(header.end(), chunk.begin(), chunk.end());
+  file.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+  WorkerPool& pool = WorkerPool::shared();
+  std::vector<Strip> batch(pool.size());
+  uint32_t adler = 1;
+  for (int first = 0; first < strips && file.good();
+      first += static_cast<int>(batch.size()))
+  {
+    const int count = MIN(static_cast<int>(batch.size()), strips - first);
+    pool.run(count, [&](int i) {
+      Strip& strip = batch[i];
+      const int y0 = (first + i) * stripCells;
+      const int y1 = MIN(y0 + stripCells, gridSize.h);
+      const int rows = (y1 - y0) * scale;
+
+      strip.translations.clear();
+      strip.colors.clear();
+      source(y0, y1, strip.translations, strip.colors);
+
+      // the same arithmetic as a frame drawn at `scale` with the strip's
+      // first row at the top of the viewport
+      Camera view;
+      view.position = vec2(0, static_cast<float>(y0));
+      view.zoom = static_cast<float>(scale);
+      view.viewport = ivec2(static_cast<int>(width), rows);
+      // resize clears to zero, black once the alpha is dropped
+      strip.raster.resize(view.viewport);
+      strip.raster.drawRows(0, rows, strip.translations, strip.colors,
+          quadSize, view);
+
+      strip.scanlines.resize(rowBytes * rows);
+      const uint32_t* pixels = strip.raster.pixels().data();
+      for (int y = 0; y < rows; ++y)
+      {
+        uint8_t* line = strip.scanlines.data() + y * rowBytes;
+        *line++ = 0; // filter: none
+        for (uint64_t x = 0; x < width; ++x, ++pixels)
+        {
+          *line++ = static_cast<uint8_t>(*pixels);
+          *line++ = static_cast<uint8_t>(*pixels >> 8);
+          *line++ = static_cast<uint8_t>(*pixels >> 16);
+        }
+      }
+
+      strip.adler = Deflate::adler32(strip.scanlines.data(),
+          strip.scanlines.size());
+      beginChunk(strip.chunk, "IDAT");
+      Deflate::compress(strip.scanlines.data(), strip.scanlines.size(),
+          first + i == strips - 1, strip.chunk);
+      sealChunk(strip.chunk);
+    });
+
+    for (int i = 0; i < count; ++i)
+    {
+      adler = Deflate::adler32Combine(adler, batch[i].adler,
+          batch[i].scanlines.size());
+      file.write(reinterpret_cast<const char*>(batch[i].chunk.data()),
+          batch[i].chunk.size());
+    }
+  }
+
+  beginChunk(chunk, "IDAT");
+  putU32(chunk, adler);
+  sealChunk(chunk);
+  file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+  beginChunk(chunk, "IEND");
+  sealChunk(chunk);
+  file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+  if (!file.good())
+  {
+    ErrorReturn(false, "Failed to write %s", filename.data());
+  }
+
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  Printf("Poster %s: %llux%llu in %d strips, %.2f s", filename.data(),
+      static_cast<unsigned long long>(width),
+      static_cast<unsigned long long>(height), strips, seconds);
+  return true;
+}
+
+} // namespace ge
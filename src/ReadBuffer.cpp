@@ -29,4 +29,24 @@ std::optional<std::string> File::read(std::string_view filename)
   return ss.str();
 }
 
+bool File::writePPM(std::string_view filename, int width, int height,
+    const std::vector<uint8_t>& rgba)
+{
+  std::ofstream file(std::string(filename), std::ofstream::binary);
+  if (!file.is_open())
+  {
+    ErrorReturn(false, "Failed to open file %s", filename.data());
+  }
+  file << "P6\n" << width << ' ' << height << "\n255\n";
+  std::vector<char> rgb(static_cast<size_t>(width) * height * 3);
+  for (size_t i = 0, j = 0; j < rgb.size(); i += 4, j += 3)
+  {
+    rgb[j] = rgba[i];
+    rgb[j + 1] = rgba[i + 1];
+    rgb[j + 2] = rgba[i + 2];
+  }
+  file.write(rgb.data(), rgb.size());
+  return file.good();
+}
+
 } // namespace ge
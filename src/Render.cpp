@@ -10,6 +10,19 @@
 #include "Log.hpp"
 #include "ShaderProgram.hpp"
 #include "Game.hpp"
+#include "Capture.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "VirtualTexture.hpp"
+
+#include <algorithm>
+
+#if defined(GE_OFFSCREEN_EGL)
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#elif defined(GE_OFFSCREEN_OSMESA)
+#include <GL/osmesa.h>
+#endif
 
 namespace ge
 {
@@ -17,7 +30,6 @@ namespace ge
 static uint32_t flushCounter;
 
 static GLFWwindow* m_window;
-static ivec2 m_gridSize;
 static ivec2 m_size;
 static ivec2 m_tileSize;
 static ShaderProgram program;
@@ -34,14 +46,69 @@ struct DrawObject
 };
 
 static DrawObject quadObject;
+// instances the translation/colour buffers can hold
+static size_t quadCapacity;
+static int cameraLocation;
+static int quadSizeLocation;
+
+// state texture drawn this frame by a GPU simulator, replayed by present()
+struct GridPass
+{
+  uint32_t texture;
+  ivec2 gridSize;
+  float lod;
+};
 
-static void initDrawObjects(float side, ivec2 gridSize);
+static ShaderProgram gridProgram;
+static uint32_t gridVao;
+static uint32_t paletteTexture;
+static GridPass gridPass;
+static int gridCameraLocation;
+static int gridSizeLocation;
+static int gridLodLocation;
+
+// paged grid drawn this frame, replayed by present()
+static ShaderProgram virtualProgram;
+static const VirtualTexture* virtualPass;
+static int virtualOriginLocation;
+static int virtualZoomLocation;
+static int virtualWindowLocation;
+static int virtualLevelLocation;
+
+static bool initContext(GLADloadproc loader);
+static void initDrawObjects(size_t capacity);
 static void loadProgram();
 static void flush();
+static void drawGridPass();
+static void drawVirtualPass();
+static void swap();
 
-static void internalInit(int side, ivec2 gridSize)
+// offscreen mode renders into this framebuffer instead of a window
+struct OffscreenTarget
 {
-  initDrawObjects((float)side, gridSize);
+  uint32_t framebuffer, colorBuffer;
+#if defined(GE_OFFSCREEN_EGL)
+  EGLDisplay display;
+  EGLContext context;
+#elif defined(GE_OFFSCREEN_OSMESA)
+  OSMesaContext context;
+  std::vector<uint8_t> buffer;
+#endif
+};
+
+static bool offscreen = false;
+static OffscreenTarget target;
+static Capture* capture = nullptr;
+
+// software mode: no GL at all, frames are rasterized on the CPU
+static bool software = false;
+static SoftwareRasterizer raster;
+static float softwareQuadSize = Render::CellQuadSize;
+
+static void internalInit(ivec2 size)
+{
+  // one instance per visible cell or block, never more than one per pixel
+  initDrawObjects(static_cast<size_t>(size.w + 2) * (size.h + 2));
   loadProgram();
 }
 
@@ -54,8 +121,8 @@ struct Vertex
 std::vector<vec4> colors;
 std::vector<vec2> translations;
 static size_t totalQuads = 0;
-
-static void initDrawObjects();
+// instances left in the GPU buffers by the last flush
+static GLsizei cachedQuads = 0;
 
 bool Render::Init(GLFWwindow** window, const std::string& title, ivec2 size, ivec2 tileSize)
 {
@@ -114,32 +181,166 @@ bool Render::Init(GLFWwindow** window, const std::string& title, ivec2 size, ive
 
   m_size = ivec2{mode->width, mode->height};
   m_tileSize = tileSize;
-  m_gridSize = {
-    m_size.x / m_tileSize.x,
-    m_size.y / m_tileSize.y,
-  };
-  Game::Context.GridSize = m_gridSize;
+  Game::Context.View.viewport = m_size;
   AssertReturn(m_window != nullptr, false, "Failed to create window");
   *window = m_window;
   glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
 
   glfwMakeContextCurrent(m_window);
 
-  AssertReturn(gladLoadGLLoader((GLADloadproc)glfwGetProcAddress), false, "Failed to load GL");
+  return initContext((GLADloadproc)glfwGetProcAddress);
+}
+
+bool initContext(GLADloadproc loader)
+{
+  AssertReturn(gladLoadGLLoader(loader), false, "Failed to load GL");
   Print("OpenGL Loaded...");
   Print("Vendor:      ", glGetString(GL_VENDOR));
   Print("Renderer:    ", glGetString(GL_RENDERER));
   Print("Version:     ", glGetString(GL_VERSION));
+  ShaderProgram::initBinaryCache(loader);
 
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  internalInit(m_tileSize.x, m_gridSize);
+  internalInit(m_size);
+  return true;
+}
+
+bool Render::InitOffscreen(ivec2 size)
+{
+  m_size = size;
+  Game::Context.View.viewport = m_size;
+
+#if defined(GE_OFFSCREEN_EGL)
+  auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+    eglGetProcAddress("eglGetPlatformDisplayEXT");
+  AssertReturn(getPlatformDisplay, false, "EGL_EXT_platform_base missing");
+  target.display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+      EGL_DEFAULT_DISPLAY, nullptr);
+  EGLint major, minor;
+  AssertReturn(eglInitialize(target.display, &major, &minor), false,
+      "Failed to init EGL surfaceless display: 0x%x", eglGetError());
+  AssertReturn(eglBindAPI(EGL_OPENGL_API), false, "EGL has no desktop GL");
+  const EGLint attribs[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 3,
+    EGL_CONTEXT_MINOR_VERSION, 3,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE
+  };
+  target.context = eglCreateContext(target.display, EGL_NO_CONFIG_KHR,
+      EGL_NO_CONTEXT, attribs);
+  AssertReturn(target.context != EGL_NO_CONTEXT, false,
+      "Failed to create EGL context: 0x%x", eglGetError());
+  AssertReturn(eglMakeCurrent(target.display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+      target.context), false, "Failed to make EGL context current");
+  GLADloadproc loader = (GLADloadproc)eglGetProcAddress;
+#elif defined(GE_OFFSCREEN_OSMESA)
+  const int attribs[] = {
+    OSMESA_FORMAT, OSMESA_RGBA,
+    OSMESA_DEPTH_BITS, 0,
+    OSMESA_STENCIL_BITS, 0,
+    OSMESA_ACCUM_BITS, 0,
+    OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+    OSMESA_CONTEXT_MAJOR_VERSION, 3,
+    OSMESA_CONTEXT_MINOR_VERSION, 3,
+    0
+  };
+  target.context = OSMesaCreateContextAttribs(attribs, nullptr);
+  AssertReturn(target.context, false, "Failed to create OSMesa context");
+  // everything is drawn into the framebuffer below, this only binds the context
+  target.buffer.resize(4);
+  AssertReturn(OSMesaMakeCurrent(target.context, target.buffer.data(),
+      GL_UNSIGNED_BYTE, 1, 1), false, "Failed to make OSMesa context current");
+  GLADloadproc loader = (GLADloadproc)OSMesaGetProcAddress;
+#else
+  GLADloadproc loader = nullptr;
+  ErrorReturn(false, "Built without an offscreen backend "
+      "(GE_OFFSCREEN_EGL or GE_OFFSCREEN_OSMESA)");
+#endif
+
+  offscreen = true;
+  AssertReturn(initContext(loader), false, "Failed to init offscreen GL");
+
+  glGenFramebuffers(1, &target.framebuffer);
+  glGenRenderbuffers(1, &target.colorBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, target.colorBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_size.w, m_size.h);
+  glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+      GL_RENDERBUFFER, target.colorBuffer);
+  AssertReturn(
+      glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE,
+      false, "Offscreen framebuffer is incomplete");
+  glViewport(0, 0, m_size.w, m_size.h);
+  return true;
+}
+
+bool Render::InitSoftware(ivec2 size)
+{
+  m_size = size;
+  Game::Context.View.viewport = m_size;
+  raster.resize(m_size);
+  software = true;
+  Print("Software rasterizer:", m_size.w, "x", m_size.h);
   return true;
 }
 
+uint32_t Render::targetFramebuffer()
+{
+  return offscreen ? target.framebuffer : 0;
+}
+
+void Render::readPixels(std::vector<uint8_t>& rgba)
+{
+  const size_t stride = static_cast<size_t>(m_size.w) * 4;
+  rgba.resize(stride * m_size.h);
+  if (software)
+  {
+    const auto& pixels = raster.pixels();
+    std::copy(reinterpret_cast<const uint8_t*>(pixels.data()),
+        reinterpret_cast<const uint8_t*>(pixels.data() + pixels.size()),
+        rgba.data());
+    return;
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer());
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, m_size.w, m_size.h, GL_RGBA, GL_UNSIGNED_BYTE,
+      rgba.data());
+  // GL rows start at the bottom, images at the top
+  std::vector<uint8_t> row(stride);
+  for (int y = 0; y < m_size.h / 2; ++y)
+  {
+    uint8_t* top = rgba.data() + y * stride;
+    uint8_t* bottom = rgba.data() + (m_size.h - 1 - y) * stride;
+    std::copy(top, top + stride, row.data());
+    std::copy(bottom, bottom + stride, top);
+    std::copy(row.data(), row.data() + stride, bottom);
+  }
+}
+
+ivec2 Render::getSize()
+{
+  return m_size;
+}
+
+void Render::setCapture(Capture* recorder)
+{
+  capture = recorder;
+}
+
 void Render::begin()
 {
+  if (software)
+  {
+    raster.clear({ 0, 0, 0, 1 });
+    return;
+  }
+  const Camera& view = Game::Context.View;
+  program.use();
+  glUniform3f(cameraLocation, view.position.x, view.position.y, view.zoom);
+  gridPass.texture = 0;
+  virtualPass = nullptr;
   // glClearColor(0.1, 0.08, 0.02, 1.0);
   glClearColor(0, 0, 0, 1.0);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -147,16 +348,60 @@ void Render::begin()
 
 void Render::end()
 {
+  if (software)
+  {
+    raster.draw(translations, colors, softwareQuadSize, Game::Context.View);
+    colors.clear();
+    translations.clear();
+    return;
+  }
   flush();
-  glfwSwapBuffers(m_window);
+  swap();
   // Printf("Flushed %d times this frame", flushCounter);
   // flushCounter = 0;
 }
 
+void Render::present()
+{
+  if (software)
+    return; // the last frame is still in the CPU framebuffer
+  glClearColor(0, 0, 0, 1.0);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  drawGridPass();
+  drawVirtualPass();
+  program.use();
+  glBindVertexArray(quadObject.vao);
+  glDrawArraysInstanced(GL_TRIANGLES, 0, 6, cachedQuads);
+  swap();
+}
+
+void swap()
+{
+  if (capture)
+    capture->readFrame();
+  if (offscreen)
+  {
+    // nothing to present; finish so frame timings include the GPU work
+    glFinish();
+    return;
+  }
+  glfwSwapBuffers(m_window);
+}
+
 void flush()
 {
   program.use();
   glBindVertexArray(quadObject.vao);
+  if (colors.size() > quadCapacity)
+  {
+    quadCapacity = colors.size();
+    glBindBuffer(GL_ARRAY_BUFFER, quadObject.vboTrans);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * quadCapacity, nullptr,
+        GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, quadObject.vboCol);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vec4) * quadCapacity, nullptr,
+        GL_DYNAMIC_DRAW);
+  }
   glBindBuffer(GL_ARRAY_BUFFER, quadObject.vboTrans);
   glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vec2) * translations.size(),
       translations.data());
@@ -164,13 +409,130 @@ void flush()
   glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vec4) * colors.size(),
       colors.data());
   glDrawArraysInstanced(GL_TRIANGLES, 0, 6, colors.size());
+  cachedQuads = colors.size();
   colors.clear();
   translations.clear();
 }
 
 void Render::Quit()
 {
-  glfwTerminate();
+  if (software)
+    return;
+  if (!offscreen)
+  {
+    glfwTerminate();
+    return;
+  }
+  glDeleteRenderbuffers(1, &target.colorBuffer);
+  glDeleteFramebuffers(1, &target.framebuffer);
+#if defined(GE_OFFSCREEN_EGL)
+  eglMakeCurrent(target.display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+      EGL_NO_CONTEXT);
+  eglDestroyContext(target.display, target.context);
+  eglTerminate(target.display);
+#elif defined(GE_OFFSCREEN_OSMESA)
+  OSMesaDestroyContext(target.context);
+#endif
+}
+
+void Render::setGridPalette(const std::vector<vec4>& colors)
+{
+  if (paletteTexture == 0)
+    glGenTextures(1, &paletteTexture);
+  glBindTexture(GL_TEXTURE_2D, paletteTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, colors.size(), 1, 0, GL_RGBA,
+      GL_FLOAT, colors.data());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+void Render::drawGrid(uint32_t stateTexture, ivec2 gridSize)
+{
+  if (software)
+    return;
+  const Camera& view = Game::Context.View;
+  int block = view.blockSize();
+  float lod = 0;
+  if (block > 1)
+  {
+    // the mip chain averages the alive channel into block densities
+    glBindTexture(GL_TEXTURE_2D, stateTexture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    lod = std::log2(static_cast<float>(block));
+  }
+  gridPass = { stateTexture, gridSize, lod };
+
+  gridProgram.use();
+  glUniform3f(gridCameraLocation, view.position.x, view.position.y, view.zoom);
+  glUniform2f(gridSizeLocation, gridSize.w, gridSize.h);
+  glUniform1f(gridLodLocation, lod);
+  drawGridPass();
+}
+
+void drawGridPass()
+{
+  if (gridPass.texture == 0)
+    return;
+  gridProgram.use();
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, paletteTexture);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, gridPass.texture);
+  if (gridPass.lod > 0)
+  {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+        GL_NEAREST_MIPMAP_NEAREST);
+  }
+  glBindVertexArray(gridVao);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  // the simulation pass only has level 0 of the other texture
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+}
+
+void Render::drawVirtual(const VirtualTexture& texture)
+{
+  if (software)
+    return;
+  virtualPass = &texture;
+  drawVirtualPass();
+}
+
+void drawVirtualPass()
+{
+  if (virtualPass == nullptr)
+    return;
+  const VirtualTexture& texture = *virtualPass;
+  const Camera& view = Game::Context.View;
+  const int shift = VirtualTexture::PageShift + texture.level();
+  const ivec2 first = texture.windowOrigin();
+  const ivec2 grid = texture.gridSize();
+  // in double: far from the origin a float cell position has no fraction
+  const double x0 = static_cast<double>(first.x) * (1 << shift);
+  const double y0 = static_cast<double>(first.y) * (1 << shift);
+  const double w = MIN(static_cast<double>(texture.windowSize().w) * (1 << shift),
+      grid.w - x0);
+  const double h = MIN(static_cast<double>(texture.windowSize().h) * (1 << shift),
+      grid.h - y0);
+
+  virtualProgram.use();
+  glUniform2f(virtualOriginLocation, (x0 - view.position.x) * view.zoom,
+      (y0 - view.position.y) * view.zoom);
+  glUniform1f(virtualZoomLocation, view.zoom);
+  glUniform2f(virtualWindowLocation, w, h);
+  glUniform1i(virtualLevelLocation, texture.level());
+  glActiveTexture(GL_TEXTURE2);
+  glBindTexture(GL_TEXTURE_2D, texture.indirection());
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, paletteTexture);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture.atlas());
+  glBindVertexArray(gridVao);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+bool Render::isSoftware()
+{
+  return software;
 }
 
 void Render::fillRect(vec2 pos, vec4 color)
@@ -179,7 +541,16 @@ void Render::fillRect(vec2 pos, vec4 color)
   colors.push_back(color);
 }
 
-void initDrawObjects(float side, ivec2 gridSize)
+void Render::setQuadSize(float cells)
+{
+  softwareQuadSize = cells;
+  if (software)
+    return;
+  program.use();
+  glUniform1f(quadSizeLocation, cells);
+}
+
+void initDrawObjects(size_t capacity)
 {
   // float quadVertices[] = {
   //    0,        0,
@@ -190,7 +561,8 @@ void initDrawObjects(float side, ivec2 gridSize)
   //    0,        side - 1
   // };
 
-  float s = side * 0.7;
+  // unit quad, scaled to cells by the quadSize uniform
+  float s = 1.f;
   float quadVertices[] = {
      0, 0,
      s, 0,
@@ -212,7 +584,8 @@ void initDrawObjects(float side, ivec2 gridSize)
   glEnableVertexAttribArray(0);
 
   glBindBuffer(GL_ARRAY_BUFFER, quadObject.vboTrans);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * gridSize.w * gridSize.h, nullptr,
+  quadCapacity = capacity;
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * quadCapacity, nullptr,
       GL_DYNAMIC_DRAW);
 
   glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vec2), 0);
@@ -220,7 +593,7 @@ void initDrawObjects(float side, ivec2 gridSize)
   glVertexAttribDivisor(1, 1);
 
   glBindBuffer(GL_ARRAY_BUFFER, quadObject.vboCol);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vec4) * gridSize.w * gridSize.h, nullptr,
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vec4) * quadCapacity, nullptr,
       GL_DYNAMIC_DRAW);
 
   glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(vec4), 0);
@@ -230,9 +603,6 @@ void initDrawObjects(float side, ivec2 gridSize)
 
 void loadProgram()
 {
-  program.load("shaders/default.vert", "shaders/default.frag");
-  program.use();
-  auto location = glGetUniformLocation(program.getId(), "projection");
   float mat[16] = {0};
   // vec2 scale(1.f, 1.f);
   // glfwGetWindowContentScale(m_window, &scale.x, &scale.y);
@@ -250,7 +620,46 @@ void loadProgram()
   mat[13] = -(t+b)/(t-b);
   mat[14] = -(f+n)/(f-n);
   mat[15] = 1;
+
+  program.load("shaders/default.vert", "shaders/default.frag");
+  program.use();
+  auto location = glGetUniformLocation(program.getId(), "projection");
+  glUniformMatrix4fv(location, 1, GL_FALSE, mat);
+  cameraLocation = glGetUniformLocation(program.getId(), "camera");
+  quadSizeLocation = glGetUniformLocation(program.getId(), "quadSize");
+  glUniform1f(quadSizeLocation, Render::CellQuadSize);
+
+  gridProgram.load("shaders/grid.vert", "shaders/grid.frag");
+  gridProgram.use();
+  location = glGetUniformLocation(gridProgram.getId(), "projection");
+  glUniformMatrix4fv(location, 1, GL_FALSE, mat);
+  gridCameraLocation = glGetUniformLocation(gridProgram.getId(), "camera");
+  gridSizeLocation = glGetUniformLocation(gridProgram.getId(), "gridSize");
+  gridLodLocation = glGetUniformLocation(gridProgram.getId(), "lod");
+  glUniform1f(glGetUniformLocation(gridProgram.getId(), "quadSize"),
+      Render::CellQuadSize);
+  glUniform1i(glGetUniformLocation(gridProgram.getId(), "state"), 0);
+  glUniform1i(glGetUniformLocation(gridProgram.getId(), "palette"), 1);
+  glGenVertexArrays(1, &gridVao);
+
+  virtualProgram.load("shaders/virtual.vert", "shaders/virtual.frag");
+  virtualProgram.use();
+  location = glGetUniformLocation(virtualProgram.getId(), "projection");
   glUniformMatrix4fv(location, 1, GL_FALSE, mat);
+  virtualOriginLocation = glGetUniformLocation(virtualProgram.getId(), "origin");
+  virtualZoomLocation = glGetUniformLocation(virtualProgram.getId(), "zoom");
+  virtualWindowLocation =
+    glGetUniformLocation(virtualProgram.getId(), "windowCells");
+  virtualLevelLocation = glGetUniformLocation(virtualProgram.getId(), "level");
+  glUniform1f(glGetUniformLocation(virtualProgram.getId(), "quadSize"),
+      Render::CellQuadSize);
+  glUniform1i(glGetUniformLocation(virtualProgram.getId(), "pageShift"),
+      VirtualTexture::PageShift);
+  glUniform1i(glGetUniformLocation(virtualProgram.getId(), "atlasPages"),
+      VirtualTexture::AtlasPages);
+  glUniform1i(glGetUniformLocation(virtualProgram.getId(), "atlas"), 0);
+  glUniform1i(glGetUniformLocation(virtualProgram.getId(), "palette"), 1);
+  glUniform1i(glGetUniformLocation(virtualProgram.getId(), "indirection"), 2);
 }
 
 } // namespace ge
@@ -11,10 +11,52 @@
 #include "Log.hpp"
 
 #include <glad/glad.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+// GL 4.1 / ARB_get_program_binary, not part of the 3.3 core loader
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program,
+    GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program,
+    GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program,
+    GLenum pname, GLint value);
 
 namespace ge
 {
 
+static PFNGLGETPROGRAMBINARYPROC getProgramBinary;
+static PFNGLPROGRAMBINARYPROC programBinary;
+static PFNGLPROGRAMPARAMETERIPROC programParameteri;
+// vendor, renderer and version strings; any driver change misses the cache
+static std::string driverId;
+
+static constexpr const char* CacheDirectory = "shaders/cache";
+static constexpr uint32_t CacheMagic = 0x42505347; // "GSPB"
+
+struct CacheHeader
+{
+  uint32_t magic;
+  uint32_t format;
+  uint64_t key;
+  uint64_t length;
+};
+
+static uint64_t hash(std::string_view data, uint64_t h = 14695981039346656037ull)
+{
+  for (unsigned char c : data)
+  {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
 static const char* ShadersLut(GLenum type)
 {
   switch (type)
@@ -28,14 +70,11 @@ static const char* ShadersLut(GLenum type)
   }
 }
 
-static uint32_t compileShader(std::string_view filename, GLenum type)
+static uint32_t compileShader(const std::string& buffer,
+    std::string_view filename, GLenum type)
 {
-  auto buffer = File::read(filename);
-  if (!buffer)
-    ErrorReturn(-1, "Failed to create %s from %s", ShadersLut(type),
-        filename.data());
   uint32_t shader = glCreateShader(type);
-  const char* source = buffer->c_str();
+  const char* source = buffer.c_str();
   glShaderSource(shader, 1, &source, NULL);
   glCompileShader(shader);
   int success;
@@ -51,15 +90,111 @@ static uint32_t compileShader(std::string_view filename, GLenum type)
   return shader;
 }
 
+static std::filesystem::path cachePath(std::string_view vertFilename,
+    std::string_view fragFilename)
+{
+  std::filesystem::path vert(vertFilename), frag(fragFilename);
+  return std::filesystem::path(CacheDirectory) /
+    (vert.stem().string() + "-" + frag.stem().string() + ".bin");
+}
+
+static bool loadCached(uint32_t program, const std::filesystem::path& path,
+    uint64_t key)
+{
+  std::ifstream file(path, std::ifstream::binary);
+  CacheHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || header.magic != CacheMagic || header.key != key)
+  {
+    return false;
+  }
+  std::vector<char> binary(header.length);
+  if (!file.read(binary.data(), binary.size()))
+    return false;
+  programBinary(program, header.format, binary.data(), binary.size());
+  int success;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  return success;
+}
+
+static void storeCached(uint32_t program, const std::filesystem::path& path,
+    uint64_t key)
+{
+  int length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+  std::vector<char> binary(length);
+  GLenum format;
+  getProgramBinary(program, length, &length, &format, binary.data());
+
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+  if (!file.is_open())
+  {
+    Error("Failed to write program cache %s", path.c_str());
+    return;
+  }
+  CacheHeader header { CacheMagic, format, key,
+    static_cast<uint64_t>(length) };
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(binary.data(), length);
+}
+
 ShaderProgram::ShaderProgram() : m_id(-1) { }
 
+void ShaderProgram::initBinaryCache(void* (*loader)(const char*))
+{
+  getProgramBinary = (PFNGLGETPROGRAMBINARYPROC)loader("glGetProgramBinary");
+  programBinary = (PFNGLPROGRAMBINARYPROC)loader("glProgramBinary");
+  programParameteri =
+    (PFNGLPROGRAMPARAMETERIPROC)loader("glProgramParameteri");
+  int formats = 0;
+  if (getProgramBinary && programBinary && programParameteri)
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  glGetError(); // the query is invalid on contexts without the extension
+  if (formats <= 0)
+  {
+    getProgramBinary = nullptr;
+    Print("Program binary cache disabled: no binary formats");
+    return;
+  }
+  driverId = std::string(reinterpret_cast<const char*>(glGetString(GL_VENDOR)))
+    + '\n' + reinterpret_cast<const char*>(glGetString(GL_RENDERER))
+    + '\n' + reinterpret_cast<const char*>(glGetString(GL_VERSION));
+}
+
 void ShaderProgram::load(std::string_view vertFilename, std::string_view fragFilename)
 {
-  uint32_t vertexShader = compileShader(vertFilename, GL_VERTEX_SHADER);
-  uint32_t fragmentShader = compileShader(fragFilename, GL_FRAGMENT_SHADER);
+  auto vertSource = File::read(vertFilename);
+  auto fragSource = File::read(fragFilename);
+  if (!vertSource || !fragSource)
+  {
+    Error("Failed to read shaders %s and %s", vertFilename.data(),
+        fragFilename.data());
+    m_id = -1;
+    return;
+  }
+
   m_id = glCreateProgram();
+  const bool cached = getProgramBinary != nullptr;
+  const uint64_t key = hash(driverId, hash(*fragSource, hash(*vertSource)));
+  const auto path = cachePath(vertFilename, fragFilename);
+  if (cached && loadCached(m_id, path, key))
+  {
+    return;
+  }
+
+  // missing, stale or rejected by the driver: build from source
+  uint32_t vertexShader = compileShader(*vertSource, vertFilename,
+      GL_VERTEX_SHADER);
+  uint32_t fragmentShader = compileShader(*fragSource, fragFilename,
+      GL_FRAGMENT_SHADER);
   glAttachShader(m_id, vertexShader);
   glAttachShader(m_id, fragmentShader);
+  if (cached)
+    programParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
   glLinkProgram(m_id);
   int success;
   glGetProgramiv(m_id, GL_LINK_STATUS, & success);
@@ -72,6 +207,10 @@ void ShaderProgram::load(std::string_view vertFilename, std::string_view fragFil
     Error("Failed to link Program from %s: %s", names.c_str(), log);
     m_id = -1;
   }
+  else if (cached)
+  {
+    storeCached(m_id, path, key);
+  }
   glDeleteShader(vertexShader);
   glDeleteShader(fragmentShader);
 }
@@ -9,22 +9,76 @@
 #include "Simulator.hpp"
 #include "Render.hpp"
 #include "Game.hpp"
+#include "Poster.hpp"
+#include "Log.hpp"
+#include "WorkerPool.hpp"
 
 #include <random>
-#include <thread>
 #include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <ctime>
+#include <cstring>
+#include <bit>
 
 namespace ge
 {
 
+// Zobrist key of the cell at (x, y): a fixed random word per cell, so the
+// XOR of the keys of the live cells stands for the grid and a changed
+// cell updates it with one XOR
+static uint64_t cellKey(int x, int y)
+{
+  uint64_t z = (static_cast<uint64_t>(y) << 32 | static_cast<uint32_t>(x))
+    + 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
 Simulator::Simulator(GameContext& context)
     : State{context}
+    , m_activityKnown{false}
     , m_pause{false}
     , m_resetRequested{false}
+    , m_virtualTexturing{false}
+    , m_gpuTrails{false}
+    , m_historyMode{false}
+    , m_historyDepth{0}
+    , m_period{0}
+    , m_engine{Engine::Banded}
+    , m_adaptive{false}
+    , m_accum{0}
+    , m_stampRefresh{0}
+    , m_gridHash{0}
+    , m_hashNext{0}
+    , m_cyclePeriod{0}
+    , m_stableSince{0}
+    , m_candidatePeriod{0}
+    , m_candidateSince{0}
+    , m_candidateAt{0}
+    , m_onCycle{OnCycle::Report}
+    , m_fastForwardTo{0}
 {
+  // the death stamps reset() writes depend on the fade count
+  initFadeColors();
   init(context.GridSize, context.Side);
   fillWithRandom();
-  initFadeColors();
+  updatePyramid();
+  rescan();
+  if (!Render::isSoftware())
+  {
+    // past the texture limit no state-texture renderer could show the grid
+    int maxSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    m_virtualTexturing = m_gridSize.w > maxSize || m_gridSize.h > maxSize;
+  }
+}
+
+Simulator::~Simulator()
+{
+  m_virtual.quit();
+  m_trails.quit();
 }
 
 void Simulator::init(const ivec2& gridSize, const int side)
@@ -36,27 +90,83 @@ void Simulator::init(const ivec2& gridSize, const int side)
 
 void Simulator::reset()
 {
-  m_cells1.clear();
-  m_cells2.clear();
-  m_cells1.resize(m_gridSize.w * m_gridSize.h);
-  m_cells2.resize(m_gridSize.w * m_gridSize.h);
+  m_tiles.init(m_gridSize);
+  // every temporal tile starts on a storage tile
+  static_assert(TemporalTile % GridTiles::TileSize == 0);
+  m_temporalTiles.clear();
+  for (int i = 0; i < m_tiles.tileCount(); ++i)
+  {
+    const ivec2 origin = m_tiles.tile(i).origin;
+    if (origin.x % TemporalTile == 0 && origin.y % TemporalTile == 0)
+      m_temporalTiles.push_back(origin);
+  }
+  m_tileNeighbours.resize(m_tiles.tileCount());
+  for (int i = 0; i < m_tiles.tileCount(); ++i)
+  {
+    const GridTiles::Tile& tile = m_tiles.tile(i);
+    const int xs[] = { tile.origin.x - 1, tile.origin.x,
+      tile.origin.x + tile.size.w };
+    const int ys[] = { tile.origin.y - 1, tile.origin.y,
+      tile.origin.y + tile.size.h };
+    int k = 0;
+    for (int y : ys)
+      for (int x : xs)
+        if (x != tile.origin.x || y != tile.origin.y)
+          m_tileNeighbours[i][k++] = m_tiles.tileAt(
+              (x + m_gridSize.w) % m_gridSize.w,
+              (y + m_gridSize.h) % m_gridSize.h);
+  }
+  m_tileChanged.assign(m_tiles.tileCount(), 1);
+  m_activityKnown = false;
+  m_tileLive.assign(m_tiles.tileCount(), 0);
+  m_tileRows.assign(m_tiles.tileCount(), 0);
+  m_tileCols.assign(m_tiles.tileCount(), 0);
+  // a restart of the same grid refills the mappings it already has
+  m_cells1.assign(m_tiles.cellCount(), 0);
+  // the in-place engine works on a single copy
+  if (m_engine != Engine::InPlace)
+    m_cells2.assign(m_tiles.cellCount(), 0);
+  else
+    m_cells2.release();
+  m_deathGen.assign(m_tiles.cellCount(), longDead());
   m_nextArray = m_cells2.data();
   m_currentArray = m_cells1.data();
+  if (m_engine == Engine::InPlace)
+    m_nextArray = m_currentArray;
+  m_pyramid.init(m_gridSize);
+  m_pyramid.markAllChanged();
+  m_pageStamps.clear();
+  m_pageCounts.clear();
+  ivec2 pages = {
+    (m_gridSize.w + VirtualTexture::PageSize - 1) >> VirtualTexture::PageShift,
+    (m_gridSize.h + VirtualTexture::PageSize - 1) >> VirtualTexture::PageShift,
+  };
+  for (;;)
+  {
+    m_pageCounts.push_back(pages);
+    m_pageStamps.emplace_back(static_cast<size_t>(pages.w) * pages.h, 0);
+    if (pages.w == 1 && pages.h == 1)
+      break;
+    pages = { (pages.w + 1) / 2, (pages.h + 1) / 2 };
+  }
 }
 
 void Simulator::fillWithRandom()
 {
   std::random_device rd;
-  std::mt19937 gen(rd());
-  int initialCellsCount = m_gridSize.w * m_gridSize.h * InitCellsCountPercentage
-                        / 100;
-  std::uniform_int_distribution<int> rndIndex(0, m_gridSize.w * m_gridSize.h);
-  for (int i = 0; i < initialCellsCount; ++i)
+  std::mt19937 gen(m_context.Seed ? m_context.Seed : rd());
+  const int64_t cells = static_cast<int64_t>(m_gridSize.w) * m_gridSize.h;
+  int64_t initialCellsCount = cells * InitCellsCountPercentage / 100;
+  std::uniform_int_distribution<int64_t> rndIndex(0, cells - 1);
+  for (int64_t i = 0; i < initialCellsCount; ++i)
   {
-    int candidate = rndIndex(gen);
-    if (m_cells1[candidate].value == 0)
+    int64_t candidate = rndIndex(gen);
+    const size_t cell = m_tiles.index(
+        static_cast<int>(candidate % m_gridSize.w),
+        static_cast<int>(candidate / m_gridSize.w));
+    if (m_cells1[cell] == 0)
     {
-      m_cells1[candidate].value = 1;
+      m_cells1[cell] = 1;
     }
     else
       --i;
@@ -65,17 +175,24 @@ void Simulator::fillWithRandom()
 
 void Simulator::initFadeColors()
 {
-  m_actualFades = FadeGrades / UpdateEvery;
-  m_fadeColors.resize(m_actualFades);
-  for (int i = 0; i < m_actualFades; ++i)
+  m_fadeColors = fadePalette();
+  m_actualFades = static_cast<int>(m_fadeColors.size());
+}
+
+std::vector<vec4> Simulator::fadePalette()
+{
+  const int fades = FadeGrades / UpdateEvery;
+  std::vector<vec4> colors(fades);
+  for (int i = 0; i < fades; ++i)
   {
-    float t = std::sin((static_cast<float>(i) / m_actualFades) * M_PI_2);
+    float t = std::sin((static_cast<float>(i) / fades) * M_PI_2);
     float tt = t * t;
-    m_fadeColors[i].x = 0.1f * tt;
-    m_fadeColors[i].y = 0.1f * tt;
-    m_fadeColors[i].z = 0.7f * tt;
-    m_fadeColors[i].w = 1.f;
+    colors[i].x = 0.1f * tt;
+    colors[i].y = 0.1f * tt;
+    colors[i].z = 0.7f * tt;
+    colors[i].w = 1.f;
   }
+  return colors;
 }
 
 bool Simulator::update(const float delta)
@@ -88,120 +205,1085 @@ bool Simulator::update(const float delta)
   {
     m_resetRequested = true;
   }
+  if (Game::isKeyJustPressed(Key::AutoReseed))
+  {
+    m_onCycle = m_onCycle == OnCycle::Reseed ? OnCycle::Report
+      : OnCycle::Reseed;
+    Printf("New soup once the grid repeats %s",
+        m_onCycle == OnCycle::Reseed ? "on" : "off");
+  }
+  if (Game::isKeyJustPressed(Key::VirtualTexture) && !Render::isSoftware())
+  {
+    m_virtualTexturing = !m_virtualTexturing;
+    Printf("Virtual texturing %s", m_virtualTexturing ? "on" : "off");
+  }
+  if (Game::isKeyJustPressed(Key::FadeTrails) && !Render::isSoftware())
+  {
+    m_gpuTrails = !m_gpuTrails;
+    Printf("GPU fade trails %s", m_gpuTrails ? "on" : "off");
+  }
+  if (Game::isKeyJustPressed(Key::History))
+  {
+    setHistoryMode(!m_historyMode);
+  }
+  if (Game::isKeyJustPressed(Key::Rewind))
+  {
+    rewind(1);
+  }
+  if (Game::isKeyJustPressed(Key::Poster))
+  {
+    char name[32];
+    std::time_t t = std::time(nullptr);
+    std::strftime(name, sizeof(name), "poster-%Y%m%d-%H%M%S.png",
+        std::localtime(&t));
+    exportPoster(name, m_side);
+  }
 
-  static int accum = 0;
-  accum++;
-  if (accum < UpdateEvery)
+  if (Game::isKeyJustPressed(Key::Engine))
+  {
+    setEngine(static_cast<Engine>((static_cast<int>(engine()) + 1)
+          % EngineCount));
+  }
+
+  if (++m_accum < UpdateEvery)
   {
     return false;
   }
-  accum = 0;
-  std::vector<std::thread> pool;
-  int dividor = 8;
-  int y_stride = m_gridSize.h / (dividor - 1);
-  for (int i = 0; i < dividor; i = i + 2)
+  m_accum = 0;
+  step();
+  return false;
+}
+
+void Simulator::step()
+{
+  const auto start = std::chrono::steady_clock::now();
+  m_stepStamp = static_cast<uint16_t>(m_context.Generation + 1);
+  if (m_context.Generation - m_stampRefresh >= StampRefreshPeriod)
   {
-    pool.emplace_back(
-        &Simulator::calculateNext,
-        *this,
-        i * y_stride * m_gridSize.w,
-        MIN((i + 1) * y_stride * m_gridSize.w, m_gridSize.w * m_gridSize.h)
-        );
+    refreshDeathStamps();
+    m_stampRefresh = m_context.Generation;
   }
-  for (auto& t : pool) t.join();
-  pool.clear();
 
-  for (int i = 1; i < dividor; i = i + 2)
+  int generations = 1;
+  if (m_engine == Engine::TemporalBlocked)
+  {
+    generations = TemporalDepth;
+    WorkerPool& pool = WorkerPool::shared();
+    const size_t tiles = m_temporalTiles.size();
+    const size_t workers = pool.size();
+    resetBandStats(workers);
+    pool.runEach([&](int worker) {
+      for (size_t i = tiles * worker / workers;
+          i < tiles * (worker + 1) / workers; ++i)
+      {
+        advanceTile(m_temporalTiles[i].x, m_temporalTiles[i].y, generations,
+            m_bandStats[worker]);
+      }
+    });
+  }
+  else if (m_engine == Engine::InPlace)
   {
-    pool.emplace_back(
-        &Simulator::calculateNext,
-        *this,
-        i * y_stride * m_gridSize.w,
-        MIN((i + 1) * y_stride * m_gridSize.w, m_gridSize.w * m_gridSize.h)
-        );
+    advanceInPlace();
   }
-  for (auto& t : pool) t.join();
+  else
+  {
+    // runs of active tiles in storage order; every worker starts on its
+    // band, where its memory was first touched, and then steals from the
+    // bands that hold more of the activity
+    findActiveTiles();
+    WorkerPool& pool = WorkerPool::shared();
+    cutTasks(pool.size());
+    resetBandStats(pool.size());
+    pool.runStealing(m_workerTasks, [&](int task, int worker) {
+      const int begin = m_taskStarts[task];
+      calculateNext(m_activeTiles.data() + begin,
+          m_taskStarts[task + 1] - begin, m_bandStats[worker]);
+    });
+  }
+  m_activityKnown = m_engine == Engine::Banded;
+  mergeStats();
 
-  swapArrays();
+  if (m_engine != Engine::InPlace)
+    swapArrays();
 
+  const bool reseed = m_resetRequested;
   if (m_resetRequested)
   {
     m_resetRequested = false;
     reset();
     fillWithRandom();
+    if (m_historyMode)
+      startHistory();
   }
+  else if (m_historyMode)
+  {
+    m_historyDepth = MIN(m_historyDepth + generations, History);
+    if (m_context.Generation / History
+        != (m_context.Generation + generations) / History)
+      logPeriod();
+  }
+  m_context.Generation += generations;
+  updatePyramid();
+  if (reseed)
+    rescan();
+  else
+    trackCycle();
+  if (m_adaptive)
+  {
+    adapt(generations, std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count());
+  }
+}
 
-  return false;
+void Simulator::adapt(const int generations, const double seconds)
+{
+  const AdaptiveEngine::Regime regime = m_adaptiveEngine.record({ generations,
+      population(), m_pyramid.changedFraction(), seconds },
+      m_context.Generation);
+  const Engine engine = regime == AdaptiveEngine::Regime::Dense
+    ? Engine::TemporalBlocked : Engine::Banded;
+  if (engine != m_engine)
+    useEngine(engine);
+}
+
+void Simulator::setEngine(Engine engine)
+{
+  m_adaptive = engine == Engine::Adaptive;
+  if (m_adaptive)
+  {
+    Printf("Engine: adaptive, banded while sparse, temporal while dense");
+    m_adaptiveEngine.reset(AdaptiveEngine::Regime::Sparse);
+    if (m_engine != Engine::Banded)
+      useEngine(Engine::Banded);
+    return;
+  }
+  useEngine(engine);
+}
+
+void Simulator::useEngine(Engine engine)
+{
+  if (engine == Engine::InPlace && m_engine != Engine::InPlace)
+  {
+    // keep the current generation in m_cells1 and give the other back
+    if (m_currentArray != m_cells1.data())
+      m_cells1.swap(m_cells2);
+    m_cells2.release();
+    m_currentArray = m_nextArray = m_cells1.data();
+  }
+  else if (engine != Engine::InPlace && m_engine == Engine::InPlace)
+  {
+    m_cells2.assign(m_cells1.size(), 0);
+    m_currentArray = m_cells1.data();
+    m_nextArray = m_cells2.data();
+  }
+  // the other engines do not keep the tile changes
+  m_activityKnown = false;
+  m_engine = engine;
+  static const char* names[] = {
+    "banded, one generation per pass",
+    "temporally blocked tiles",
+    "in place with rolling rows",
+  };
+  Printf("Engine: %s", names[static_cast<int>(engine)]);
+}
+
+void Simulator::advanceInPlace()
+{
+  WorkerPool& pool = WorkerPool::shared();
+  const int bands = MIN(pool.size() * 4, m_gridSize.h);
+  const size_t w = m_gridSize.w;
+  auto bandBegin = [&](int band) {
+    return static_cast<int>(static_cast<int64_t>(m_gridSize.h) * band / bands);
+  };
+
+  // the first and last row of every band, as they were before the pass;
+  // they are all the neighbouring bands read of each other
+  m_boundaryRows.resize(bands * 2 * w);
+  pool.run(bands, [&](int band) {
+    m_tiles.readRow(m_currentArray, 0, bandBegin(band), m_gridSize.w,
+        m_boundaryRows.data() + band * 2 * w);
+    m_tiles.readRow(m_currentArray, 0, bandBegin(band + 1) - 1, m_gridSize.w,
+        m_boundaryRows.data() + (band * 2 + 1) * w);
+  });
+
+  resetBandStats(bands);
+  pool.run(bands, [&](int band) {
+    thread_local std::vector<uint8_t> rolling[3];
+    thread_local std::vector<uint8_t> next;
+    for (auto& row : rolling)
+      row.resize(w);
+    next.resize(w);
+    const int y0 = bandBegin(band);
+    const int y1 = bandBegin(band + 1);
+    const uint8_t* above = m_boundaryRows.data()
+      + (((band + bands - 1) % bands) * 2 + 1) * w;
+    const uint8_t* nextTop = m_boundaryRows.data()
+      + ((band + 1) % bands) * 2 * w;
+    // rows are gathered from their tiles, so the one below is read
+    // before this one is written back
+    m_tiles.readRow(m_currentArray, 0, y0, m_gridSize.w, rolling[0].data());
+    for (int y = y0; y < y1; ++y)
+    {
+      const uint8_t* original = rolling[(y - y0) % 3].data();
+      const uint8_t* below = nextTop;
+      if (y + 1 < y1)
+      {
+        uint8_t* row = rolling[(y + 1 - y0) % 3].data();
+        m_tiles.readRow(m_currentArray, 0, y + 1, m_gridSize.w, row);
+        below = row;
+      }
+      advanceRow(above, original, below, next.data(), y, m_bandStats[band]);
+      above = original;
+    }
+  });
+}
+
+void Simulator::advanceRow(const uint8_t* up, const uint8_t* mid,
+    const uint8_t* down, uint8_t* out, const int y, BandStats& band)
+{
+  const int w = m_gridSize.w;
+  auto next = [&](int l, int x, int r) {
+    const int n = up[l] + up[x] + up[r] + mid[l] + mid[r] + down[l] + down[x]
+      + down[r];
+    return static_cast<uint8_t>((n == 3) | ((n == 2) & mid[x]));
+  };
+  // the torus seam at both ends, the rest without wrapping
+  out[0] = next(w - 1, 0, 1 % w);
+  for (int x = 1; x < w - 1; ++x)
+  {
+    out[x] = next(x - 1, x, x + 1);
+  }
+  if (w > 1)
+    out[w - 1] = next(w - 2, w - 1, 0);
+
+  const bool stampDeaths = !m_gpuTrails && !m_historyMode;
+  uint64_t* history = m_historyMode ? m_history.data() : nullptr;
+  // the row goes back into its tiles along with the bookkeeping
+  GridStats& stats = band.stats;
+  int first = w;
+  int last = -1;
+  m_tiles.forEachRun({ 0, y }, { w, y + 1 }, [&](ivec2 cell, size_t i,
+        int count) {
+    std::memcpy(m_currentArray + i, out + cell.x, count);
+    for (int x = cell.x; x < cell.x + count; ++x, ++i)
+    {
+      if (history)
+      {
+        history[i] = (history[i] >> 1)
+          | static_cast<uint64_t>(out[x]) << (History - 1);
+      }
+      if (out[x])
+      {
+        ++stats.population;
+        first = MIN(first, x);
+        last = x;
+      }
+      if (out[x] == mid[x])
+        continue;
+      m_pyramid.markChanged(x, y, band.changedTiles);
+      band.hash ^= cellKey(x, y);
+      if (out[x])
+        ++stats.births;
+      else
+        ++stats.deaths;
+      if (stampDeaths && !out[x])
+        m_deathGen[i] = m_stepStamp;
+    }
+  });
+  if (last >= 0)
+    stats.include(first, y, last, y);
+}
+
+void Simulator::findActiveTiles()
+{
+  // every cell's history shifts each generation, changed or not
+  const bool all = !m_activityKnown || m_historyMode;
+  m_activeTiles.clear();
+  for (int t = 0; t < m_tiles.tileCount(); ++t)
+  {
+    bool active = all || m_tileChanged[t];
+    for (int k = 0; k < 8 && !active; ++k)
+      active = m_tileChanged[m_tileNeighbours[t][k]];
+    if (active)
+      m_activeTiles.push_back(t);
+  }
+}
+
+void Simulator::cutTasks(const int workers)
+{
+  // the same task size everywhere, so a busy band has tasks to spare
+  const int active = static_cast<int>(m_activeTiles.size());
+  const int chunk = MAX(active / (workers * TasksPerWorker), 1);
+  m_taskStarts.clear();
+  m_workerTasks.resize(workers + 1);
+  int first = 0;
+  for (int w = 0; w < workers; ++w)
+  {
+    m_workerTasks[w] = static_cast<int>(m_taskStarts.size());
+    const int bandEnd = static_cast<int>(
+        static_cast<int64_t>(m_tiles.tileCount()) * (w + 1) / workers);
+    const int last = static_cast<int>(std::lower_bound(
+          m_activeTiles.begin() + first, m_activeTiles.end(), bandEnd)
+        - m_activeTiles.begin());
+    for (; first < last; first += MIN(chunk, last - first))
+    {
+      m_taskStarts.push_back(first);
+    }
+  }
+  m_workerTasks[workers] = static_cast<int>(m_taskStarts.size());
+  m_taskStarts.push_back(active);
+}
+
+void Simulator::calculateNext(const int* tiles, const int count,
+    BandStats& band)
+{
+  constexpr int S = GridTiles::TileSize;
+  // byte stores may alias members, keep the mode flags out of the loop
+  const bool stampDeaths = !m_gpuTrails && !m_historyMode;
+  uint64_t* history = m_historyMode ? m_history.data() : nullptr;
+  uint64_t hash = 0;
+  uint64_t births = 0;
+  uint64_t deaths = 0;
+  for (int k = 0; k < count; ++k)
+  {
+    const int t = tiles[k];
+    const GridTiles::Tile& tile = m_tiles.tile(t);
+    bool changed = false;
+    uint32_t live = 0;
+    uint64_t rows = 0;
+    uint64_t cols = 0;
+    for (int ly = 0; ly < tile.size.h; ++ly)
+    {
+      uint8_t rowLive = 0;
+      for (int lx = 0; lx < tile.size.w; ++lx)
+      {
+        const int x = tile.origin.x + lx;
+        const int y = tile.origin.y + ly;
+        const size_t i = tile.base + ly * S + lx;
+        int calc = 0;
+        if (lx > 0 && ly > 0 && lx + 1 < tile.size.w && ly + 1 < tile.size.h)
+        {
+          // inside the tile the rows above and below are a tile row away
+          const uint8_t* c = m_currentArray + i;
+          calc = c[-S - 1] + c[-S] + c[-S + 1] + c[-1] + c[1] + c[S - 1] + c[S]
+            + c[S + 1];
+        }
+        else
+        {
+          for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+              if (dx || dy)
+                calc += m_currentArray[m_tiles.wrappedIndex(x + dx, y + dy)];
+        }
+
+        const uint8_t current = m_currentArray[i];
+        uint8_t next = current;
+        if ((calc < 2 || calc > 3) && current == 1)
+        {
+          next = 0;
+          // the only write fading needs: the age follows from the generation
+          if (stampDeaths)
+            m_deathGen[i] = m_stepStamp;
+          m_pyramid.markChanged(x, y, band.changedTiles);
+          hash ^= cellKey(x, y);
+          ++deaths;
+          changed = true;
+        }
+        else if(calc == 3 && current != 1)
+        {
+          next = 1;
+          m_pyramid.markChanged(x, y, band.changedTiles);
+          hash ^= cellKey(x, y);
+          ++births;
+          changed = true;
+        }
+        m_nextArray[i] = next;
+        live += next;
+        rowLive |= next;
+        cols |= static_cast<uint64_t>(next) << lx;
+        if (history)
+        {
+          history[i] = (history[i] >> 1)
+            | static_cast<uint64_t>(next) << (History - 1);
+        }
+      }
+      rows |= static_cast<uint64_t>(rowLive) << ly;
+    }
+    m_tileChanged[t] = changed;
+    m_tileLive[t] = live;
+    m_tileRows[t] = rows;
+    m_tileCols[t] = cols;
+  }
+  band.hash ^= hash;
+  band.stats.births += births;
+  band.stats.deaths += deaths;
+}
+
+void Simulator::advanceTile(const int x0, const int y0, const int depth,
+    BandStats& band)
+{
+  // a tile plus a halo of `depth` cells; every generation the valid part
+  // shrinks by one cell per side until only the tile is left
+  thread_local std::vector<uint8_t> buffers[2];
+  const int tw = MIN(TemporalTile, m_gridSize.w - x0);
+  const int th = MIN(TemporalTile, m_gridSize.h - y0);
+  const int lw = tw + 2 * depth;
+  const int lh = th + 2 * depth;
+  buffers[0].resize(static_cast<size_t>(lw) * lh);
+  buffers[1].resize(static_cast<size_t>(lw) * lh);
+
+  for (int ly = 0; ly < lh; ++ly)
+  {
+    const int gy = ((y0 - depth + ly) % m_gridSize.h + m_gridSize.h)
+      % m_gridSize.h;
+    m_tiles.readRow(m_currentArray, x0 - depth, gy, lw,
+        buffers[0].data() + static_cast<size_t>(ly) * lw);
+  }
+
+  const bool stampDeaths = !m_gpuTrails && !m_historyMode;
+  uint64_t* history = m_historyMode ? m_history.data() : nullptr;
+  for (int s = 1; s <= depth; ++s)
+  {
+    const uint8_t* src = buffers[(s - 1) & 1].data();
+    uint8_t* dst = buffers[s & 1].data();
+    for (int ly = s; ly < lh - s; ++ly)
+    {
+      const uint8_t* up = src + static_cast<size_t>(ly - 1) * lw;
+      const uint8_t* mid = up + lw;
+      const uint8_t* down = mid + lw;
+      uint8_t* out = dst + static_cast<size_t>(ly) * lw;
+      for (int lx = s; lx < lw - s; ++lx)
+      {
+        const int n = up[lx - 1] + up[lx] + up[lx + 1] + mid[lx - 1]
+          + mid[lx + 1] + down[lx - 1] + down[lx] + down[lx + 1];
+        out[lx] = (n == 3) | ((n == 2) & mid[lx]);
+      }
+    }
+
+    if (!stampDeaths && !history)
+      continue;
+    // the tile's own cells are exact at every step, record their deaths
+    const uint16_t stamp = static_cast<uint16_t>(m_stepStamp + s - 1);
+    m_tiles.forEachRun({ x0, y0 }, { x0 + tw, y0 + th }, [&](ivec2 cell,
+          size_t i, int count) {
+      const size_t local = static_cast<size_t>(cell.y - y0 + depth) * lw
+        + cell.x - x0 + depth;
+      const uint8_t* before = src + local;
+      const uint8_t* after = dst + local;
+      for (int x = 0; x < count; ++x, ++i)
+      {
+        if (stampDeaths && before[x] && !after[x])
+          m_deathGen[i] = stamp;
+        if (history)
+        {
+          history[i] = (history[i] >> 1)
+            | static_cast<uint64_t>(after[x]) << (History - 1);
+        }
+      }
+    });
+  }
+
+  // every storage tile lies inside one temporal tile, and is counted anew
+  for (int y = y0; y < y0 + th; y += GridTiles::TileSize)
+  {
+    for (int x = x0; x < x0 + tw; x += GridTiles::TileSize)
+    {
+      const int t = m_tiles.tileAt(x, y);
+      m_tileLive[t] = 0;
+      m_tileRows[t] = 0;
+      m_tileCols[t] = 0;
+    }
+  }
+  const uint8_t* result = buffers[depth & 1].data();
+  GridStats& stats = band.stats;
+  m_tiles.forEachRun({ x0, y0 }, { x0 + tw, y0 + th }, [&](ivec2 cell,
+        size_t i, int count) {
+    const uint8_t* cells = result
+      + static_cast<size_t>(cell.y - y0 + depth) * lw + cell.x - x0 + depth;
+    std::memcpy(m_nextArray + i, cells, count);
+    uint32_t live = 0;
+    uint64_t cols = 0;
+    for (int x = 0; x < count; ++x)
+    {
+      live += cells[x];
+      cols |= static_cast<uint64_t>(cells[x])
+        << ((cell.x + x) & (GridTiles::TileSize - 1));
+      if (cells[x] != m_currentArray[i + x])
+      {
+        m_pyramid.markChanged(cell.x + x, cell.y, band.changedTiles);
+        band.hash ^= cellKey(cell.x + x, cell.y);
+        if (cells[x])
+          ++stats.births;
+        else
+          ++stats.deaths;
+      }
+    }
+    const int t = m_tiles.tileAt(cell.x, cell.y);
+    m_tileLive[t] += live;
+    m_tileRows[t] |= static_cast<uint64_t>(live > 0)
+      << (cell.y & (GridTiles::TileSize - 1));
+    m_tileCols[t] |= cols;
+  });
+}
+
+int Simulator::fadeAt(size_t i) const
+{
+  if (m_historyMode)
+  {
+    // the newest state is the top bit, so the leading zeros count the
+    // generations since the cell was last alive
+    const int age = std::countl_zero(m_history[i]) - 1;
+    return age < m_actualFades ? m_actualFades - age : 0;
+  }
+  const uint16_t age =
+    static_cast<uint16_t>(m_context.Generation) - m_deathGen[i];
+  return age < m_actualFades ? m_actualFades - age : 0;
+}
+
+uint16_t Simulator::longDead() const
+{
+  return static_cast<uint16_t>(m_context.Generation - m_actualFades);
+}
+
+void Simulator::refreshDeathStamps()
+{
+  // stamps wrap after 65536 generations; pinning finished fades to the
+  // edge of the window keeps them from reading as fresh deaths again
+  const uint16_t dead = longDead();
+  for (size_t i = 0; i < m_deathGen.size(); ++i)
+  {
+    if (fadeAt(i) == 0)
+      m_deathGen[i] = dead;
+  }
+}
+
+void Simulator::setHistoryMode(bool enabled)
+{
+  m_historyMode = enabled;
+  if (enabled)
+  {
+    startHistory();
+  }
+  else
+  {
+    // finished fades only; the stamps were not kept up in history mode
+    m_deathGen.assign(m_deathGen.size(), longDead());
+    m_history.release();
+  }
+  stampAllPages();
+  Printf("Cell history %s", enabled ? "on" : "off");
+}
+
+void Simulator::startHistory()
+{
+  m_history.assign(m_cells1.size(), 0);
+  for (size_t i = 0; i < m_history.size(); ++i)
+  {
+    m_history[i] = static_cast<uint64_t>(m_currentArray[i]) << (History - 1);
+  }
+  m_historyDepth = 1;
+  m_period = 0;
+}
+
+bool Simulator::rewind(int generations)
+{
+  if (!m_historyMode)
+    return false;
+  generations = MIN(generations, m_historyDepth - 1);
+  if (generations <= 0)
+    return false;
+  // older states move up; the bits shifted in are generations never seen
+  for (size_t i = 0; i < m_history.size(); ++i)
+  {
+    m_history[i] <<= generations;
+    m_currentArray[i] = static_cast<uint8_t>(m_history[i] >> (History - 1));
+  }
+  m_historyDepth -= generations;
+  m_activityKnown = false;
+  m_pyramid.markAllChanged();
+  // a new state for everything keyed on the generation
+  ++m_context.Generation;
+  updatePyramid();
+  rescan();
+  return true;
+}
+
+int Simulator::cellPeriod(int x, int y) const
+{
+  if (!m_historyMode)
+    return 0;
+  const uint64_t h = m_history[m_tiles.index(x, y)];
+  for (int p = 1; p * 2 <= m_historyDepth; ++p)
+  {
+    if (((h ^ (h >> p)) & periodMask(p)) == 0)
+      return p;
+  }
+  return 0;
+}
+
+int Simulator::gridPeriod() const
+{
+  if (!m_historyMode)
+    return 0;
+  for (int p = 1; p * 2 <= m_historyDepth; ++p)
+  {
+    const uint64_t mask = periodMask(p);
+    uint64_t differs = 0;
+    for (size_t i = 0; i < m_history.size() && !differs; i += 4096)
+    {
+      const size_t end = MIN(i + 4096, m_history.size());
+      for (size_t j = i; j < end; ++j)
+      {
+        differs |= (m_history[j] ^ (m_history[j] >> p)) & mask;
+      }
+    }
+    if (!differs)
+      return p;
+  }
+  return 0;
+}
+
+uint64_t Simulator::periodMask(int period) const
+{
+  // bit i of h >> p is state i + p, compared where both are recorded
+  const int compared = m_historyDepth - period;
+  return ((compared >= History ? ~0ull : (1ull << compared) - 1)
+      << (History - m_historyDepth));
+}
+
+void Simulator::logPeriod()
+{
+  const int period = gridPeriod();
+  if (period != m_period && period > 0)
+  {
+    Printf("Generation %llu: the grid repeats with period %d",
+        static_cast<unsigned long long>(m_context.Generation), period);
+  }
+  m_period = period;
 }
 
-void Simulator::calculateNext(const size_t begin, const size_t end)
+void Simulator::setOnCycle(OnCycle action, uint64_t fastForwardTo)
 {
-  for (size_t i = begin; i < end; ++i)
+  m_onCycle = action;
+  m_fastForwardTo = fastForwardTo;
+}
+
+void Simulator::rescan()
+{
+  WorkerPool& pool = WorkerPool::shared();
+  std::atomic<uint64_t> hash{0};
+  pool.run(m_tiles.tileCount(), [&](int t) {
+    const GridTiles::Tile& tile = m_tiles.tile(t);
+    uint64_t local = 0;
+    uint32_t live = 0;
+    uint64_t rows = 0;
+    uint64_t cols = 0;
+    for (int ly = 0; ly < tile.size.h; ++ly)
+    {
+      const uint8_t* row = m_currentArray + tile.base
+        + ly * GridTiles::TileSize;
+      for (int lx = 0; lx < tile.size.w; ++lx)
+      {
+        if (!row[lx])
+          continue;
+        local ^= cellKey(tile.origin.x + lx, tile.origin.y + ly);
+        ++live;
+        rows |= 1ull << ly;
+        cols |= 1ull << lx;
+      }
+    }
+    m_tileLive[t] = live;
+    m_tileRows[t] = rows;
+    m_tileCols[t] = cols;
+    hash ^= local;
+  });
+  m_gridHash = hash;
+  m_stats = GridStats();
+  addTileStats(m_stats);
+
+  m_hashHistory.clear();
+  m_hashNext = 0;
+  m_cyclePeriod = 0;
+  m_stableSince = 0;
+  m_candidatePeriod = 0;
+  m_hashHistory.emplace_back(m_context.Generation, m_gridHash);
+}
+
+void Simulator::resetBandStats(size_t count)
+{
+  m_bandStats.resize(count);
+  for (BandStats& band : m_bandStats)
   {
-    size_t x = i % m_gridSize.w;
-    size_t y = i / m_gridSize.w;
-    int calc =
-        m_currentArray[(x + 1) % m_gridSize.w
-                + y * m_gridSize.w].value
-      + m_currentArray[(x - 1 + m_gridSize.w) % m_gridSize.w
-                + y * m_gridSize.w].value
-      + m_currentArray[x
-                + ((y + 1) % m_gridSize.h) * m_gridSize.w].value
-      + m_currentArray[x
-                + ((y - 1 + m_gridSize.h) % m_gridSize.h) * m_gridSize.w].value
-      + m_currentArray[(x + 1) % m_gridSize.w
-                + ((y + 1) % m_gridSize.h) * m_gridSize.w].value
-      + m_currentArray[(x - 1 + m_gridSize.w) % m_gridSize.w
-                + ((y - 1 + m_gridSize.h) % m_gridSize.h) * m_gridSize.w].value
-      + m_currentArray[(x + 1) % m_gridSize.w
-                + ((y - 1 + m_gridSize.h) % m_gridSize.h) * m_gridSize.w].value
-      + m_currentArray[(x - 1 + m_gridSize.w) % m_gridSize.w
-                + ((y + 1) % m_gridSize.h) * m_gridSize.w].value;
+    band.stats = GridStats();
+    band.hash = 0;
+    band.changedTiles.clear();
+  }
+}
 
-    Cell& cc = m_currentArray[i];
-    Cell& nc = m_nextArray[i];
-    if ((calc < 2 || calc > 3) && cc.value == 1)
+void Simulator::mergeStats()
+{
+  GridStats stats;
+  for (BandStats& band : m_bandStats)
+  {
+    stats.merge(band.stats);
+    m_gridHash ^= band.hash;
+    m_pyramid.takeChanged(band.changedTiles);
+  }
+  // the in-place bands see every cell; the other passes skip tiles or
+  // split them between generations, and leave their counts per tile
+  if (m_engine != Engine::InPlace)
+    addTileStats(stats);
+  m_stats = stats;
+}
+
+void Simulator::addTileStats(GridStats& stats) const
+{
+  for (int t = 0; t < m_tiles.tileCount(); ++t)
+  {
+    if (!m_tileLive[t])
+      continue;
+    const ivec2 origin = m_tiles.tile(t).origin;
+    stats.population += m_tileLive[t];
+    stats.include(origin.x + std::countr_zero(m_tileCols[t]),
+        origin.y + std::countr_zero(m_tileRows[t]),
+        origin.x + 63 - std::countl_zero(m_tileCols[t]),
+        origin.y + 63 - std::countl_zero(m_tileRows[t]));
+  }
+}
+
+void Simulator::trackCycle()
+{
+  // a repeat stays a repeat until the cells are written from outside,
+  // which rescans
+  if (m_cyclePeriod > 0)
+    return;
+  const size_t cellBytes = m_cells1.size();
+  if (m_candidatePeriod > 0
+      && m_context.Generation >= m_candidateAt + m_candidatePeriod)
+  {
+    // a hash says little on its own: the cells have to come back too
+    if (m_context.Generation == m_candidateAt + m_candidatePeriod
+        && std::memcmp(m_candidateCells.data(), m_currentArray, cellBytes) == 0)
+    {
+      m_stableSince = m_candidateSince;
+      m_cyclePeriod = m_candidatePeriod;
+    }
+    else
     {
-      nc.value = 0;
-      nc.fade = m_actualFades;
+      Printf("Generation %llu: hash repeat of generation %llu was not a cycle",
+          static_cast<unsigned long long>(m_candidateAt),
+          static_cast<unsigned long long>(m_candidateSince));
     }
-    else if(calc == 3 && cc.value != 1)
+    m_candidatePeriod = 0;
+  }
+  for (size_t k = 0; k < m_hashHistory.size() && m_cyclePeriod == 0
+      && m_candidatePeriod == 0; ++k)
+  {
+    // oldest first: every earlier state was new, so the first repeat
+    // found starts the cycle
+    const auto& [generation, hash] =
+      m_hashHistory[(m_hashNext + k) % m_hashHistory.size()];
+    if (hash == m_gridHash)
     {
-      nc.value = 1;
-      nc.fade = 0;
+      m_candidateSince = generation;
+      m_candidatePeriod = m_context.Generation - generation;
+      m_candidateAt = m_context.Generation;
+      m_candidateCells.assign(m_currentArray, m_currentArray + cellBytes);
+    }
+  }
+  if (m_cyclePeriod == 0)
+  {
+    if (m_hashHistory.size() < HashHistory)
+    {
+      m_hashHistory.emplace_back(m_context.Generation, m_gridHash);
     }
     else
     {
-      nc.value = cc.value;
-      nc.fade = MAX(cc.fade - 1, 0);
+      m_hashHistory[m_hashNext] = { m_context.Generation, m_gridHash };
+      m_hashNext = (m_hashNext + 1) % HashHistory;
     }
+    return;
+  }
+
+  Printf("Generation %llu: stable since generation %llu with period %llu",
+      static_cast<unsigned long long>(m_context.Generation),
+      static_cast<unsigned long long>(m_stableSince),
+      static_cast<unsigned long long>(m_cyclePeriod));
+  if (m_onCycle == OnCycle::Reseed)
+  {
+    // the same seed would bring back the same soup
+    if (m_context.Seed)
+      ++m_context.Seed;
+    m_resetRequested = true;
+  }
+  else if (m_onCycle == OnCycle::FastForward
+      && m_fastForwardTo > m_context.Generation)
+  {
+    const uint64_t skipped = (m_fastForwardTo - m_context.Generation)
+      / m_cyclePeriod * m_cyclePeriod;
+    m_context.Generation += skipped;
+    // the cells are as they were, the fades and histories restart
+    m_deathGen.assign(m_deathGen.size(), longDead());
+    m_stampRefresh = m_context.Generation;
+    if (m_historyMode)
+      startHistory();
+    stampAllPages();
+    Printf("Fast-forwarded %llu generations to %llu",
+        static_cast<unsigned long long>(skipped),
+        static_cast<unsigned long long>(m_context.Generation));
   }
 }
 
+void Simulator::snapshot(std::vector<uint8_t>& rows) const
+{
+  rows.resize(static_cast<size_t>(m_gridSize.w) * m_gridSize.h);
+  m_tiles.toRows(m_currentArray, rows.data());
+}
+
+void Simulator::load(const std::vector<uint8_t>& rows)
+{
+  const size_t w = m_gridSize.w;
+  m_tiles.forEachRun({ 0, 0 }, m_gridSize, [&](ivec2 cell, size_t i,
+        int count) {
+    const uint8_t* src = rows.data() + cell.y * w + cell.x;
+    for (int x = 0; x < count; ++x)
+    {
+      m_currentArray[i + x] = src[x] != 0;
+    }
+  });
+  m_activityKnown = false;
+  if (m_historyMode)
+    startHistory();
+  m_pyramid.markAllChanged();
+  ++m_context.Generation;
+  updatePyramid();
+  rescan();
+}
+
 void Simulator::swapArrays()
 {
   SWAP(m_currentArray, m_nextArray);
 }
 
+void Simulator::updatePyramid()
+{
+  // a pyramid tile row never crosses a storage tile, so it is contiguous
+  static_assert(GridTiles::TileSize % DensityPyramid::TileSize == 0);
+  m_pyramid.update([this](int x, int y) {
+    return m_currentArray + m_tiles.index(x, y);
+  });
+  constexpr int shift = VirtualTexture::PageShift - DensityPyramid::TileShift;
+  const uint32_t columns = static_cast<uint32_t>(m_pyramid.tiles().w);
+  for (uint32_t t : m_pyramid.changedTiles())
+  {
+    stampPage(static_cast<int>(t % columns) >> shift,
+        static_cast<int>(t / columns) >> shift);
+  }
+}
+
+void Simulator::stampPage(int x, int y)
+{
+  const uint64_t generation = m_context.Generation;
+  for (size_t level = 0; level < m_pageStamps.size(); ++level)
+  {
+    uint64_t& stamp = m_pageStamps[level][
+      static_cast<size_t>(y >> level) * m_pageCounts[level].w + (x >> level)];
+    // stamped by a neighbour already, and so is everything above it
+    if (stamp == generation)
+      break;
+    stamp = generation;
+  }
+}
+
+void Simulator::stampAllPages()
+{
+  for (auto& stamps : m_pageStamps)
+  {
+    stamps.assign(stamps.size(), m_context.Generation);
+  }
+}
+
+uint64_t Simulator::pageStamp(int level, ivec2 page) const
+{
+  // past the top a single page holds the grid
+  level = MIN(level, static_cast<int>(m_pageStamps.size()) - 1);
+  const ivec2 pages = m_pageCounts[level];
+  if (page.x >= pages.w || page.y >= pages.h)
+    return 0;
+  const uint64_t changed =
+    m_pageStamps[level][static_cast<size_t>(page.y) * pages.w + page.x];
+  if (level > 0)
+    return changed;
+  // level 0 holds the fades too, which go on after the cells changed
+  return MIN(changed + static_cast<uint64_t>(m_actualFades),
+      m_context.Generation);
+}
+
 void Simulator::draw()
 {
-  for (int y = 0; y < m_gridSize.h; ++y)
+  const Camera& view = m_context.View;
+  if (m_virtualTexturing)
+  {
+    if (!m_virtual.initialized())
+    {
+      Render::setGridPalette(m_fadeColors);
+      m_virtual.init(m_gridSize, [this](int level, ivec2 page,
+            uint8_t* texels) {
+          return fillPage(level, page, texels);
+        }, [this](int level, ivec2 page) {
+          return pageStamp(level, page);
+        });
+    }
+    m_virtual.update(view, m_context.Generation);
+    Render::drawVirtual(m_virtual);
+    return;
+  }
+
+  if (m_gpuTrails)
+  {
+    drawTrails();
+    return;
+  }
+
+  int block = view.blockSize();
+  if (block > 1 && m_pyramid.levels() > 0)
+  {
+    drawAggregated(block);
+    return;
+  }
+
+  Render::setQuadSize(Render::CellQuadSize);
+  ivec2 begin, end;
+  view.visibleRange(m_gridSize, 1, begin, end);
+  forEachCell(begin, end, [](vec2 position, const vec4& color) {
+    Render::fillRect(position, color);
+  });
+}
+
+template <typename Emit>
+void Simulator::forEachCell(ivec2 begin, ivec2 end, Emit&& emit) const
+{
+  static const vec4 alive(1, 1, 1, 1);
+  m_tiles.forEachRun(begin, end, [&](ivec2 cell, size_t i, int count) {
+    for (int x = cell.x; x < cell.x + count; ++x, ++i)
+    {
+      if (m_currentArray[i])
+      {
+        emit(vec2(x, cell.y), alive);
+      }
+      else if (int fade = fadeAt(i); fade > 0)
+      {
+        emit(vec2(x, cell.y), m_fadeColors[fade - 1]);
+      }
+    }
+  });
+}
+
+void Simulator::drawTrails()
+{
+  if (!m_trails.initialized())
   {
-    for (int x = 0, i = y * m_gridSize.w; x < m_gridSize.w; ++x, ++i)
+    Render::setGridPalette(m_fadeColors);
+    m_trails.init(m_gridSize, m_actualFades);
+    m_trailGeneration = m_context.Generation - 1;
+  }
+  if (m_trailGeneration != m_context.Generation)
+  {
+    snapshot(m_rows);
+    m_trails.accumulate(m_rows.data(),
+        m_context.Generation - m_trailGeneration);
+    m_trailGeneration = m_context.Generation;
+  }
+  Render::drawGrid(m_trails.texture(), m_gridSize);
+}
+
+bool Simulator::fillPage(int level, ivec2 page, uint8_t* texels) const
+{
+  constexpr int size = VirtualTexture::PageSize;
+  std::memset(texels, 0, size * size * 2);
+  // past the top of the pyramid the single texel holds the whole grid
+  const int source = MIN(level, m_pyramid.levels());
+  const ivec2 levelSize =
+    source == 0 ? m_gridSize : m_pyramid.levelSize(source);
+  const int x0 = page.x << VirtualTexture::PageShift;
+  const int y0 = page.y << VirtualTexture::PageShift;
+  const int x1 = MIN(x0 + size, levelSize.w);
+  const int y1 = MIN(y0 + size, levelSize.h);
+  const float area = static_cast<float>(1 << level) * (1 << level);
+  bool any = false;
+  if (source == 0)
+  {
+    m_tiles.forEachRun({ x0, y0 }, { x1, y1 }, [&](ivec2 cell, size_t i,
+          int count) {
+      uint8_t* out = texels + ((cell.y - y0) * size + cell.x - x0) * 2;
+      for (int x = 0; x < count; ++x, ++i, out += 2)
+      {
+        out[0] = m_currentArray[i] ? 255 : 0;
+        out[1] = out[0] ? 0 : static_cast<uint8_t>(fadeAt(i));
+        any |= (out[0] | out[1]) != 0;
+      }
+    });
+    return any;
+  }
+  for (int y = y0; y < y1; ++y)
+  {
+    uint8_t* out = texels + (y - y0) * size * 2;
+    const uint32_t* counts = m_pyramid.row(source, y);
+    for (int x = x0; x < x1; ++x, out += 2)
     {
-      if (m_nextArray[i].value)
+      if (counts[x] > 0)
       {
-        Render::fillRect(
-            { x * m_side, y * m_side },
-            { 1, 1, 1, 1 }
-            );
+        // never round a live block down to nothing
+        out[0] = static_cast<uint8_t>(
+            MAX(1.f, std::nearbyint(255.f * counts[x] / area)));
+        any = true;
       }
-      else if (m_nextArray[i].fade > 0)
+    }
+  }
+  return any;
+}
+
+bool Simulator::exportPoster(std::string_view filename, const int scale) const
+{
+  return Poster::writePNG(filename, m_gridSize, scale, Render::CellQuadSize,
+      [this](int y0, int y1, std::vector<vec2>& translations,
+          std::vector<vec4>& colors) {
+        forEachCell({ 0, y0 }, { m_gridSize.w, y1 },
+            [&](vec2 position, const vec4& color) {
+              translations.push_back(position);
+              colors.push_back(color);
+            });
+      });
+}
+
+void Simulator::drawAggregated(const int block)
+{
+  int level = 0;
+  while ((1 << level) < block)
+    ++level;
+  // past the top of the pyramid its single block covers the grid
+  level = MIN(level, m_pyramid.levels());
+  Render::setQuadSize(static_cast<float>(1 << level));
+  ivec2 begin, end;
+  m_context.View.visibleRange(m_gridSize, 1 << level, begin, end);
+
+  const float area = static_cast<float>(1 << level) * (1 << level);
+  const int x0 = begin.x >> level;
+  const int x1 = MIN((end.x + (1 << level) - 1) >> level,
+      m_pyramid.levelSize(level).w);
+  const int y1 = MIN((end.y + (1 << level) - 1) >> level,
+      m_pyramid.levelSize(level).h);
+  for (int by = begin.y >> level; by < y1; ++by)
+  {
+    const uint32_t* counts = m_pyramid.row(level, by);
+    for (int bx = x0; bx < x1; ++bx)
+    {
+      if (counts[bx] > 0)
       {
-        Render::fillRect(
-            { x * m_side, y * m_side },
-            m_fadeColors[m_nextArray[i].fade - 1]
-            );
+        // square root keeps sparse blocks visible next to dense ones
+        float shade = std::sqrt(counts[bx] / area);
+        Render::fillRect(vec2(static_cast<float>(bx << level),
+              static_cast<float>(by << level)), { shade, shade, shade, 1 });
       }
     }
   }
@@ -0,0 +1,171 @@
+//
+// SoftwareRasterizer.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "SoftwareRasterizer.hpp"
+#include "WorkerPool.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ge
+{
+
+// rows per task when splitting a frame over the worker pool
+static constexpr int BandHeight = 64;
+
+// vertices are snapped to 1/256 of a pixel like Mesa's rasterizers
+static inline float snap(float v)
+{
+  return std::nearbyint(v * 256.f) / 256.f;
+}
+
+// first pixel whose centre lies at or after `edge`
+static inline int firstCovered(float edge)
+{
+  return static_cast<int>(std::ceil(edge - 0.5f));
+}
+
+void SoftwareRasterizer::resize(ivec2 size)
+{
+  m_size = size;
+  m_pixels.assign(static_cast<size_t>(size.w) * size.h, 0);
+}
+
+uint32_t SoftwareRasterizer::pack(vec4 color)
+{
+  auto channel = [](float c) {
+    return static_cast<uint32_t>(std::nearbyint(CLAMP(c, 0.f, 1.f) * 255.f));
+  };
+  return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16
+    | channel(color.w) << 24;
+}
+
+void SoftwareRasterizer::fillSpan(uint32_t* dst, int count, uint32_t color)
+{
+  int i = 0;
+#if defined(__SSE2__)
+  const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+  for (; i + 4 <= count; i += 4)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    dst[i] = color;
+  }
+}
+
+void SoftwareRasterizer::clear(vec4 color)
+{
+  const uint32_t value = pack(color);
+  WorkerPool::shared().run((m_size.h + BandHeight - 1) / BandHeight,
+      [&](int band) {
+        const int y0 = band * BandHeight;
+        const int y1 = MIN(y0 + BandHeight, m_size.h);
+        fillSpan(m_pixels.data() + static_cast<size_t>(y0) * m_size.w,
+            (y1 - y0) * m_size.w, value);
+      });
+}
+
+// rows [y0, y1) a quad covers, same arithmetic as shaders/default.vert
+static inline void quadRows(vec2 translation, float quadSize,
+    const Camera& view, int& y0, int& y1)
+{
+  y0 = firstCovered(snap((translation.y - view.position.y) * view.zoom));
+  y1 = firstCovered(
+      snap((quadSize + translation.y - view.position.y) * view.zoom));
+}
+
+void SoftwareRasterizer::draw(const std::vector<vec2>& translations,
+    const std::vector<vec4>& colors, float quadSize, const Camera& view)
+{
+  WorkerPool& pool = WorkerPool::shared();
+  const int bands = (m_size.h + BandHeight - 1) / BandHeight;
+  const int chunks = pool.size();
+  const size_t count = translations.size();
+  m_bins.resize(static_cast<size_t>(chunks) * bands);
+  // each quad is binned into the bands it covers once, so a band only
+  // visits its own quads; the chunks are drawn in order, which keeps the
+  // quads in drawing order within a band
+  pool.run(chunks, [&](int chunk) {
+    std::vector<uint32_t>* bins =
+      m_bins.data() + static_cast<size_t>(chunk) * bands;
+    for (int band = 0; band < bands; ++band)
+    {
+      bins[band].clear();
+    }
+    for (size_t i = count * chunk / chunks; i < count * (chunk + 1) / chunks;
+        ++i)
+    {
+      int y0, y1;
+      quadRows(translations[i], quadSize, view, y0, y1);
+      y0 = MAX(y0, 0);
+      y1 = MIN(y1, m_size.h);
+      for (int band = y0 / BandHeight; y0 < y1
+          && band <= (y1 - 1) / BandHeight; ++band)
+      {
+        bins[band].push_back(static_cast<uint32_t>(i));
+      }
+    }
+  });
+  pool.run(bands, [&](int band) {
+    const int y0 = band * BandHeight;
+    const int y1 = MIN(y0 + BandHeight, m_size.h);
+    for (int chunk = 0; chunk < chunks; ++chunk)
+    {
+      for (uint32_t i : m_bins[static_cast<size_t>(chunk) * bands + band])
+      {
+        drawQuad(i, y0, y1, translations, colors, quadSize, view);
+      }
+    }
+  });
+}
+
+void SoftwareRasterizer::drawRows(int y0, int y1,
+    const std::vector<vec2>& translations, const std::vector<vec4>& colors,
+    float quadSize, const Camera& view)
+{
+  for (size_t i = 0; i < translations.size(); ++i)
+  {
+    drawQuad(i, y0, y1, translations, colors, quadSize, view);
+  }
+}
+
+void SoftwareRasterizer::drawQuad(size_t i, int y0, int y1,
+    const std::vector<vec2>& translations, const std::vector<vec4>& colors,
+    float quadSize, const Camera& view)
+{
+  int py0, py1;
+  quadRows(translations[i], quadSize, view, py0, py1);
+  py0 = MAX(py0, y0);
+  py1 = MIN(py1, y1);
+  if (py0 >= py1)
+    return;
+
+  const float left = snap((translations[i].x - view.position.x) * view.zoom);
+  const float right =
+    snap((quadSize + translations[i].x - view.position.x) * view.zoom);
+  const int px0 = MAX(firstCovered(left), 0);
+  const int px1 = MIN(firstCovered(right), m_size.w);
+  if (px0 >= px1)
+    return;
+
+  // the palette is opaque, so blending reduces to a plain store
+  const uint32_t color = pack(colors[i]);
+  for (int y = py0; y < py1; ++y)
+  {
+    fillSpan(m_pixels.data() + static_cast<size_t>(y) * m_size.w + px0,
+        px1 - px0, color);
+  }
+}
+
+} // namespace ge
@@ -0,0 +1,198 @@
+//
+// VirtualTexture.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "VirtualTexture.hpp"
+
+#include <glad/glad.h>
+
+namespace ge
+{
+
+// forget empty pages past this many, a long pan must not grow without bound
+static constexpr size_t MaxEmptyPages = 1 << 16;
+
+static uint64_t pageKey(int level, ivec2 page)
+{
+  return static_cast<uint64_t>(level) << 58
+    | static_cast<uint64_t>(page.y) << 29 | static_cast<uint64_t>(page.x);
+}
+
+void VirtualTexture::init(ivec2 gridSize, PageSource source,
+    PageStamp changed)
+{
+  m_gridSize = gridSize;
+  m_source = std::move(source);
+  m_changed = std::move(changed);
+  m_texels.resize(PageSize * PageSize * 2);
+
+  const int slots = AtlasPages * AtlasPages;
+  m_slots.assign(slots, Slot{});
+  m_freeSlots.clear();
+  for (int i = slots - 1; i >= 0; --i)
+    m_freeSlots.push_back(i);
+  m_recent.clear();
+  m_resident.clear();
+  m_empty.clear();
+
+  glGenTextures(1, &m_atlas);
+  glBindTexture(GL_TEXTURE_2D, m_atlas);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, AtlasPages * PageSize,
+      AtlasPages * PageSize, 0, GL_RG, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glGenTextures(1, &m_indirection);
+  glBindTexture(GL_TEXTURE_2D, m_indirection);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  m_tableSize = ivec2();
+}
+
+void VirtualTexture::quit()
+{
+  if (m_atlas == 0)
+    return;
+  glDeleteTextures(1, &m_atlas);
+  glDeleteTextures(1, &m_indirection);
+  m_atlas = m_indirection = 0;
+}
+
+void VirtualTexture::update(const Camera& view, uint64_t stamp)
+{
+  int level = 0;
+  while ((1 << level) < view.blockSize())
+    ++level;
+
+  // coarser levels until the window fits the atlas, so the budget holds
+  // for any viewport
+  ivec2 begin, end, first, last;
+  for (;; ++level)
+  {
+    view.visibleRange(m_gridSize, 1 << level, begin, end);
+    const int shift = PageShift + level;
+    first = { begin.x >> shift, begin.y >> shift };
+    last = { MAX(end.x - 1, begin.x) >> shift, MAX(end.y - 1, begin.y) >> shift };
+    const int64_t pages = static_cast<int64_t>(last.x - first.x + 1)
+      * (last.y - first.y + 1);
+    if (pages <= AtlasPages * AtlasPages)
+      break;
+  }
+  m_level = level;
+  m_windowOrigin = first;
+  m_windowSize = { last.x - first.x + 1, last.y - first.y + 1 };
+
+  if (m_empty.size() > MaxEmptyPages)
+    m_empty.clear();
+
+  m_table.assign(static_cast<size_t>(m_windowSize.w) * m_windowSize.h, NoPage);
+  if (end.x > begin.x && end.y > begin.y)
+  {
+    for (int y = 0; y < m_windowSize.h; ++y)
+    {
+      for (int x = 0; x < m_windowSize.w; ++x)
+      {
+        m_table[y * m_windowSize.w + x] =
+          requestPage(level, { first.x + x, first.y + y }, stamp);
+      }
+    }
+  }
+
+  glBindTexture(GL_TEXTURE_2D, m_indirection);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+  if (m_windowSize.w > m_tableSize.w || m_windowSize.h > m_tableSize.h)
+  {
+    m_tableSize = {
+      MAX(m_windowSize.w, m_tableSize.w),
+      MAX(m_windowSize.h, m_tableSize.h),
+    };
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, m_tableSize.w, m_tableSize.h,
+        0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+  }
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_windowSize.w, m_windowSize.h,
+      GL_RED_INTEGER, GL_UNSIGNED_SHORT, m_table.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+uint16_t VirtualTexture::requestPage(int level, ivec2 page, uint64_t stamp)
+{
+  const uint64_t key = pageKey(level, page);
+  const uint64_t changed = m_changed(level, page);
+  auto resident = m_resident.find(key);
+  if (resident != m_resident.end())
+  {
+    const int slot = resident->second;
+    m_recent.splice(m_recent.begin(), m_recent, m_slots[slot].recent);
+    if (m_slots[slot].stamp >= changed)
+      return static_cast<uint16_t>(slot);
+    if (!m_source(level, page, m_texels.data()))
+    {
+      releaseSlot(slot);
+      m_empty[key] = stamp;
+      return NoPage;
+    }
+    m_slots[slot].stamp = stamp;
+    upload(slot);
+    return static_cast<uint16_t>(slot);
+  }
+
+  auto empty = m_empty.find(key);
+  if (empty != m_empty.end() && empty->second >= changed)
+    return NoPage;
+  if (!m_source(level, page, m_texels.data()))
+  {
+    m_empty[key] = stamp;
+    return NoPage;
+  }
+  if (empty != m_empty.end())
+    m_empty.erase(empty);
+
+  const int slot = acquireSlot();
+  m_slots[slot].key = key;
+  m_slots[slot].stamp = stamp;
+  m_resident[key] = slot;
+  upload(slot);
+  return static_cast<uint16_t>(slot);
+}
+
+int VirtualTexture::acquireSlot()
+{
+  int slot;
+  if (!m_freeSlots.empty())
+  {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+  else
+  {
+    // the window never exceeds the atlas, so the least recently used
+    // slot is never one this update has handed out
+    slot = m_recent.back();
+    m_recent.pop_back();
+    m_resident.erase(m_slots[slot].key);
+  }
+  m_recent.push_front(slot);
+  m_slots[slot].recent = m_recent.begin();
+  return slot;
+}
+
+void VirtualTexture::releaseSlot(int slot)
+{
+  m_resident.erase(m_slots[slot].key);
+  m_recent.erase(m_slots[slot].recent);
+  m_freeSlots.push_back(slot);
+}
+
+void VirtualTexture::upload(int slot)
+{
+  glBindTexture(GL_TEXTURE_2D, m_atlas);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % AtlasPages) * PageSize,
+      (slot / AtlasPages) * PageSize, PageSize, PageSize, GL_RG,
+      GL_UNSIGNED_BYTE, m_texels.data());
+}
+
+} // namespace ge
@@ -0,0 +1,213 @@
+//
+// WorkerPool.cpp
+// GameOfLifeGEL
+//
+// Created by Usama Alshughry 19.10.2026.
+// Copyright © 2026 Usama Alshughry. All rights reserved.
+//
+
+#include "WorkerPool.hpp"
+#include "CpuTopology.hpp"
+
+namespace ge
+{
+
+WorkerPool::WorkerPool(int size)
+    : m_task{nullptr}
+    , m_count{0}
+    , m_next{0}
+    , m_busy{0}
+    , m_each{false}
+    , m_batch{0}
+    , m_stopping{false}
+    , m_callerRuns{true}
+{
+  std::vector<int> cpus;
+  if (size <= 0)
+  {
+    // the affinity mask and the cgroup quota, not the machine's CPUs
+    size = CpuTopology::workerCount();
+    cpus = CpuTopology::usableCpus();
+  }
+  // the caller is left unpinned, as the threads it starts later inherit
+  // its mask; a pinned thread of its own takes worker 0's band instead,
+  // unless there is no other worker to keep apart from
+  m_callerRuns = cpus.empty() || size == 1;
+  for (int i = m_callerRuns ? 1 : 0; i < size; ++i)
+  {
+    m_threads.emplace_back(&WorkerPool::workerLoop, this, i,
+        cpus.empty() ? -1 : cpus[i % cpus.size()]);
+  }
+  m_ranges = std::make_unique<TaskRange[]>(size);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_start.notify_all();
+  for (auto& t : m_threads) t.join();
+}
+
+int WorkerPool::size() const
+{
+  return static_cast<int>(m_threads.size()) + (m_callerRuns ? 1 : 0);
+}
+
+WorkerPool& WorkerPool::shared()
+{
+  static WorkerPool pool;
+  return pool;
+}
+
+void WorkerPool::run(int count, const std::function<void(int)>& task)
+{
+  if (m_threads.empty() || count <= 1)
+  {
+    for (int i = 0; i < count; ++i) task(i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_each = false;
+    m_busy = static_cast<int>(m_threads.size());
+    ++m_batch;
+  }
+  m_start.notify_all();
+  if (m_callerRuns)
+    drain();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this] { return m_busy == 0; });
+  m_task = nullptr;
+}
+
+void WorkerPool::runEach(const std::function<void(int)>& task)
+{
+  if (m_threads.empty())
+  {
+    task(0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_each = true;
+    m_busy = static_cast<int>(m_threads.size());
+    ++m_batch;
+  }
+  m_start.notify_all();
+  if (m_callerRuns)
+    task(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this] { return m_busy == 0; });
+  m_task = nullptr;
+}
+
+void WorkerPool::runStealing(const std::vector<int>& bands,
+    const std::function<void(int, int)>& task)
+{
+  for (int w = 0; w < size(); ++w)
+  {
+    m_ranges[w].begin = bands[w];
+    m_ranges[w].end = bands[w + 1];
+  }
+  runEach([&](int worker) {
+    TaskRange& own = m_ranges[worker];
+    uint64_t random = 0x9E3779B97F4A7C15ull * (worker + 1);
+    for (;;)
+    {
+      int i = -1;
+      {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin < own.end)
+          i = own.begin++;
+      }
+      if (i >= 0)
+        task(i, worker);
+      else if (!steal(worker, random))
+        return;
+    }
+  });
+}
+
+bool WorkerPool::steal(int worker, uint64_t& random)
+{
+  const int workers = size();
+  random ^= random << 13;
+  random ^= random >> 7;
+  random ^= random << 17;
+  const int first = static_cast<int>(random % workers);
+  for (int k = 0; k < workers; ++k)
+  {
+    const int victim = (first + k) % workers;
+    if (victim == worker)
+      continue;
+    int begin;
+    int end;
+    {
+      TaskRange& other = m_ranges[victim];
+      std::lock_guard<std::mutex> lock(other.mutex);
+      const int left = other.end - other.begin;
+      if (left <= 0)
+        continue;
+      // the back half, so the victim keeps the tasks next to its last one
+      end = other.end;
+      begin = end - (left + 1) / 2;
+      other.end = begin;
+    }
+    TaskRange& own = m_ranges[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.begin = begin;
+    own.end = end;
+    return true;
+  }
+  // a band taken just now is worked off by its thief
+  return false;
+}
+
+void WorkerPool::drain()
+{
+  for (int i = m_next++; i < m_count; i = m_next++)
+  {
+    (*m_task)(i);
+  }
+}
+
+void WorkerPool::workerLoop(int worker, int cpu)
+{
+  if (cpu >= 0)
+    CpuTopology::pinThread(cpu);
+  uint64_t seen = 0;
+  for (;;)
+  {
+    bool each;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(lock, [&] { return m_stopping || m_batch != seen; });
+      if (m_stopping)
+        return;
+      seen = m_batch;
+      each = m_each;
+    }
+    if (each)
+      (*m_task)(worker);
+    else
+      drain();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      --m_busy;
+    }
+    m_done.notify_one();
+  }
+}
+
+} // namespace ge
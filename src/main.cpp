@@ -8,9 +8,51 @@
 
 #include "Game.hpp"
 
+#include <cstdlib>
+
 int main(int argc, char *argv[])
 {
   ge::Game game("test", 1440, 900, 1, 1);
+  // --offscreen <frames> [snapshot.ppm] [capture.y4m | capture directory]
+  if (argc > 2 && std::string_view(argv[1]) == "--offscreen")
+  {
+    return game.runOffscreen(std::atoi(argv[2]), argc > 3 ? argv[3] : "",
+        argc > 4 ? argv[4] : "");
+  }
+  // --software <frames> [snapshot.ppm], same as --offscreen without GL
+  if (argc > 2 && std::string_view(argv[1]) == "--software")
+  {
+    return game.runOffscreen(std::atoi(argv[2]), argc > 3 ? argv[3] : "", "",
+        true);
+  }
+  // --poster <generations> <pixels per cell> <poster.png>
+  if (argc > 4 && std::string_view(argv[1]) == "--poster")
+  {
+    return game.runPoster(std::strtoull(argv[2], nullptr, 10),
+        std::atoi(argv[3]), argv[4]);
+  }
+  // --benchmark <width> <height> <generations>
+  if (argc > 4 && std::string_view(argv[1]) == "--benchmark")
+  {
+    return game.runBenchmark({ std::atoi(argv[2]), std::atoi(argv[3]) },
+        std::strtoull(argv[4], nullptr, 10));
+  }
+  // --soak <width> <height> <soups> <generations>
+  if (argc > 5 && std::string_view(argv[1]) == "--soak")
+  {
+    return game.runSoak({ std::atoi(argv[2]), std::atoi(argv[3]) },
+        std::strtoull(argv[4], nullptr, 10),
+        std::strtoull(argv[5], nullptr, 10));
+  }
+  // --headless <width> <height> <generations> [seed] [grid file],
+  // bit-packed
+  if (argc > 4 && std::string_view(argv[1]) == "--headless")
+  {
+    return game.runHeadless({ std::atoi(argv[2]), std::atoi(argv[3]) },
+        std::strtoull(argv[4], nullptr, 10),
+        argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1,
+        argc > 6 ? argv[6] : "");
+  }
   return game.run();
 }
 